@@ -0,0 +1,87 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the per-call cost of libdelimText's findSubString() with std::string::find() and the vectorized
+// findTextSpan() on representative log lines, for markers near the start, middle and end of each line.
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+using namespace std;
+
+#include "textSearch.h"
+#include "libdelimText/src/textUtils.h"
+
+static const char* BENCH_SQUID = "1425312106.781 time_taken=132 dns=- c_ip=10.61.38.4 cs_ip=192.12.184.10 r_ip=93.184.216.34 r_port=80 c_port=50034 s_action=TCP_MISS sc_status=200 l_err=- sc_bytes=61761 cs_method=GET c_uri=\"http://www.example.com/images/logo.png\" content_type=image/png referer=\"http://www.example.com/index.html\" user_agent=\"Mozilla/5.0 (Windows NT 6.1; WOW64; rv:35.0) Gecko/20100101 Firefox/35.0\"";
+static const char* BENCH_JUNIPER = "Mar 20 12:00:00 10.0.0.1 ns5gt: NetScreen device_id=ns5gt  [Root]system-notification-00257(traffic): start_time=\"2019-03-20 12:00:00\" duration=0 policy_id=1 service=http proto=6 src zone=Trust dst zone=Untrust action=Permit sent=1014 rcvd=2245 src=10.0.0.2 dst=93.184.216.34 src_port=50034 dst_port=80 src-xlated ip=1.2.3.4 port=1024 session_id=1234 reason=Close - TCP FIN";
+static const char* BENCH_FORTIGATE = "\"itime=1503697041\",\"date=2017-08-25\",\"time=15:37:21\",\"devid=FG1K5D3I16804933\",\"vd=root\",\"type=\"\"utm\"\"\",\"subtype=\"\"webfilter\"\"\",\"action=\"\"passthrough\"\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"cat=52\",\"catdesc=\"\"Information Technology\"\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"devname=FG1Kcopper\",\"direction=\"\"outgoing\"\"\",\"\",\"dstintf=\"\"port26\"\"\",\"dstintfrole=\"\"undefined\"\"\",\"dstip=54.243.44.67\",\"dstport=80\",\"dtime=1503675441\",\"\",\"eventtype=\"\"ftgd_allow\"\"\",\"\",\"\",\"hostname=\"\"edge.simplereach.com\"\"\",\"\",\"\",\"\",\"level=\"\"notice\"\"\",\"logid=\"\"0317013312\"\"\",\"logtime=1503697041\",\"logver=56\",\"method=\"\"domain\"\"\",\"msg=\"\"URL belongs to an allowed category in policy\"\"\",\"policyid=1\",\"\",\"\",\"profile=\"\"NTC_Web_CTA\"\"\",\"proto=6\",\"rcvdbyte=0\",\"\",\"\",\"referralurl=\"\"http://www.cracked.com/pictofacts-766-28-things-you-completely-misunderstood-as-child-part-2/\"\"\",\"reqtype=\"\"referral\"\"\",\"\",\"sentbyte=1014\",\"\",\"service=\"\"HTTP\"\"\",\"sessionid=18827768\",\"\",\"\",\"srcintf=\"\"port17\"\"\",\"srcintfrole=\"\"undefined\"\"\",\"srcip=172.31.246.13\",\"srcport=63661\"";
+
+static const struct {
+	const char* cstrName;
+	const char* cstrLine;
+	const char* cstrStart;
+	const char* cstrEnd;
+} BENCH_CASES[] = {
+	{"squid c_ip",			BENCH_SQUID,		" c_ip=",		" "},
+	{"squid referer",		BENCH_SQUID,		" referer=",	" "},
+	{"squid (missing)",	BENCH_SQUID,		" x_forward=",	" "},
+	{"juniper service",	BENCH_JUNIPER,		"service=",		" "},
+	{"juniper dst",		BENCH_JUNIPER,		"dst=",			" "},
+	{"fortigate dstip",	BENCH_FORTIGATE,	"dstip=",		"\""},
+	{"fortigate srcport",BENCH_FORTIGATE,	"srcport=",		"\""},
+};
+
+#define BENCH_ITERATIONS	1000000
+
+static volatile size_t uiSink;
+
+template <typename F> static double timeCalls(F f) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i=0; i<BENCH_ITERATIONS; i++) {
+		uiSink += f();
+	}
+	return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+}
+
+int main(int argc, const char** argv) {
+	cout << left << setw(20) << "case" << right << setw(8) << "bytes" << setw(16) << "findSubString" << setw(14) << "string::find" << setw(14) << "findTextSpan" << setw(10) << "speedup" << "\n";
+
+	for (size_t i=0; i<sizeof(BENCH_CASES)/sizeof(BENCH_CASES[0]); i++) {
+		const string strLine = BENCH_CASES[i].cstrLine;
+		const string strStart = BENCH_CASES[i].cstrStart;
+		const string strEnd = BENCH_CASES[i].cstrEnd;
+
+		double dSubString = timeCalls([&]() {
+			return findSubString(strLine, 0, strStart, strEnd).length();
+		});
+		double dFind = timeCalls([&]() {
+			size_t pos = strLine.find(strStart);
+			if (pos == string::npos) {
+				return (size_t)0;
+			}
+			pos += strStart.length();
+			size_t posEnd = strLine.find(strEnd, pos);
+			return (posEnd != string::npos ? posEnd : strLine.length()) - pos;
+		});
+		double dSpan = timeCalls([&]() {
+			return findTextSpan(&strLine, 0, BENCH_CASES[i].cstrStart, BENCH_CASES[i].cstrEnd).len;
+		});
+
+		cout << left << setw(20) << BENCH_CASES[i].cstrName << right << setw(8) << strLine.length() << fixed << setprecision(1)
+			<< setw(13) << dSubString << " ns" << setw(11) << dFind << " ns" << setw(11) << dSpan << " ns" << setw(9) << dSubString / dSpan << "x\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Writes deterministic synthetic input for a multi2mactime --type to stdout (see logGenerator.h).
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include <string>
+#include <iostream>
+#include <cstdlib>
+using namespace std;
+
+#include "popt.h"
+#include "misc/poptUtils.h"
+#include "logGenerator.h"
+
+#define GENLOGS_DEFAULT_ROWS	100000
+
+int main(int argc, const char** argv) {
+	int rv = EXIT_FAILURE;
+
+	u_int64_t uiRows = GENLOGS_DEFAULT_ROWS;
+	u_int32_t uiSeed = 1;
+
+	struct poptOption optionsTable[] = {
+		{"rows",			'r',	POPT_ARG_STRING,	NULL,	10,	"Rows to generate (not counting any header row). Defaults to 100000.", "rows"},
+		{"seed",			 0,	POPT_ARG_INT,		NULL,	20,	"Random seed; the same type, rows and seed always produce the same output. Defaults to 1.", "seed"},
+		{"version",		 0,	POPT_ARG_NONE,		NULL,	100,	"Display version.", NULL},
+		POPT_AUTOHELP
+		POPT_TABLEEND
+	};
+	poptContext optCon = poptGetContext(NULL, argc, argv, optionsTable, 0);
+	poptSetOtherOptionHelp(optCon, "[options] <type>");
+
+	int iOption = poptGetNextOpt(optCon);
+	while (iOption >= 0) {
+		switch (iOption) {
+			case 10:
+				uiRows = strtoull(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 20:
+				uiSeed = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 100:
+				version(PACKAGE, VERSION);
+				exit(EXIT_SUCCESS);
+				break;
+		}
+		iOption = poptGetNextOpt(optCon);
+	}
+
+	if (iOption != -1) {
+		usage(optCon, poptBadOption(optCon, POPT_BADOPTION_NOALIAS), poptStrerror(iOption));
+		exit(EXIT_FAILURE);
+	}
+
+	const char* cstrType = poptGetArg(optCon);
+	if (!cstrType) {
+		string strTypes;
+		for (size_t i=0; i<LOG_GENERATOR_TYPE_COUNT; i++) {
+			strTypes += (i ? ", " : "") + string(LOG_GENERATOR_TYPES[i]);
+		}
+		usage(optCon, "Missing type", strTypes.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	ios::sync_with_stdio(false);
+	if (generateLog(cstrType, uiRows, uiSeed, &cout)) {
+		rv = EXIT_SUCCESS;
+	}
+
+	poptFreeContext(optCon);
+	return rv;
+}
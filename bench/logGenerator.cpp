@@ -0,0 +1,354 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "logGenerator.h"
+
+#include <string>
+#include <ostream>
+#include <random>
+#include <cstdio>
+#include <ctime>
+using namespace std;
+
+#define LOG_GENERATOR_START	1503619200		// 2017-08-25 00:00:00 UTC
+#define LOG_GENERATOR_LINE		1024
+
+const char* LOG_GENERATOR_TYPES[] = { "squidw3c", "fortg1k5", "pix", "juniper", "symantec", "hirsch", "custfsbt", "custfsem", "cusvpns1", "griffeye", "ief", "notes", "exiftool" };
+const size_t LOG_GENERATOR_TYPE_COUNT = sizeof(LOG_GENERATOR_TYPES) / sizeof(LOG_GENERATOR_TYPES[0]);
+
+static const char* GEN_HOSTS[] = { "www.example.com", "edge.simplereach.com", "cdn.example.net", "mail.example.org", "update.example.com", "static.example.net", "api.example.com", "news.example.org" };
+static const char* GEN_WORDS[] = { "invoice", "report", "holiday", "budget", "contract", "minutes", "schedule", "photo", "backup", "proposal", "draft", "summary" };
+static const char* GEN_USERS[] = { "jsmith", "mjones", "abrown", "kwilson", "ltaylor", "rdavis", "cmiller", "pmoore" };
+static const char* GEN_SQUID_ACTIONS[] = { "TCP_MISS", "TCP_HIT", "TCP_REFRESH_MODIFIED", "TCP_DENIED", "TCP_TUNNEL" };
+static const char* GEN_CATEGORIES[] = { "1", "2", "3", "99" };
+
+#define GEN_PICK(a, r)	(a[(r) % (sizeof(a) / sizeof(a[0]))])
+
+class logGenerator {
+	public:
+		logGenerator(u_int32_t uiSeed) : m_rng(uiSeed), m_uiTime(LOG_GENERATOR_START) {
+		}
+
+		u_int32_t next() {
+			return m_rng();
+		}
+		u_int32_t next(u_int32_t uiLimit) {
+			return m_rng() % uiLimit;
+		}
+
+		// Advances 0-3 seconds per row so the output stays in time order
+		time_t nextTime() {
+			m_uiTime += next(4);
+			return m_uiTime;
+		}
+
+		const char* getIP(char* cstrIP, size_t uiSize, bool bInternal) {
+			u_int32_t uiIP = next();
+			if (bInternal) {
+				snprintf(cstrIP, uiSize, "10.%u.%u.%u", (uiIP >> 16) & 0x3f, (uiIP >> 8) & 0xff, (uiIP & 0xfd) + 1);
+			} else {
+				snprintf(cstrIP, uiSize, "%u.%u.%u.%u", 20 + ((uiIP >> 24) % 180), (uiIP >> 16) & 0xff, (uiIP >> 8) & 0xff, (uiIP & 0xfd) + 1);
+			}
+			return cstrIP;
+		}
+
+		// strftime() in UTC
+		const char* getTime(char* cstrTime, size_t uiSize, const char* cstrFormat, time_t uiTime) {
+			struct tm tmTime;
+			gmtime_r(&uiTime, &tmTime);
+			strftime(cstrTime, uiSize, cstrFormat, &tmTime);
+			return cstrTime;
+		}
+
+		// M/D/YYYY H:MM:SS AM|PM, as getUnix32DateTimeFromString() expects, or Hirsch's "M/D/YYYY  H:MM:SSAM|PM"
+		const char* getTime12(char* cstrTime, size_t uiSize, time_t uiTime, bool bHirsch = false) {
+			struct tm tmTime;
+			gmtime_r(&uiTime, &tmTime);
+			int iHour = tmTime.tm_hour % 12;
+			snprintf(cstrTime, uiSize, (bHirsch ? "%d/%d/%d  %d:%02d:%02d%s" : "%d/%d/%d %d:%02d:%02d %s"), tmTime.tm_mon + 1, tmTime.tm_mday, tmTime.tm_year + 1900,
+						(iHour ? iHour : 12), tmTime.tm_min, tmTime.tm_sec, (tmTime.tm_hour < 12 ? "AM" : "PM"));
+			return cstrTime;
+		}
+
+		// iWords 32 bit words as hex digits
+		const char* getHex(char* cstrHex, size_t uiSize, int iWords, bool bUpper) {
+			for (int i=0; i<iWords && (size_t)(i * 8) < uiSize; i++) {
+				snprintf(cstrHex + i * 8, uiSize - i * 8, (bUpper ? "%08X" : "%08x"), next());
+			}
+			return cstrHex;
+		}
+
+	private:
+		mt19937 m_rng;
+		time_t m_uiTime;
+};
+
+// Every random value is drawn in its own statement; the evaluation order of function arguments is unspecified, so
+// drawing them inside the snprintf() argument lists could produce different output from different compilers.
+
+static void generateSquidW3c(logGenerator* pGen, char* cstrLine) {
+	char cstrClient[16], cstrRemote[16];
+	time_t uiTime = pGen->nextTime();
+	u_int32_t uiMillis = pGen->next(1000);
+	u_int32_t uiTaken = pGen->next(5000);
+	pGen->getIP(cstrClient, sizeof(cstrClient), true);
+	pGen->getIP(cstrRemote, sizeof(cstrRemote), false);
+	u_int32_t uiPort = 1024 + pGen->next(60000);
+	const char* cstrAction = GEN_PICK(GEN_SQUID_ACTIONS, pGen->next());
+	u_int32_t uiStatus = (pGen->next(10) ? 200 : 404);
+	u_int32_t uiBytes = pGen->next(500000);
+	const char* cstrHost = GEN_PICK(GEN_HOSTS, pGen->next());
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiImage = pGen->next(10000);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%lu.%03u time_taken=%u dns=- c_ip=%s cs_ip=192.12.184.10 r_ip=%s r_port=80 c_port=%u s_action=%s sc_status=%u l_err=- sc_bytes=%u cs_method=GET "
+				"c_uri=\"http://%s/images/%s%u.png\" content_type=image/png referer=\"http://%s/index.html\" user_agent=\"Mozilla/5.0 (Windows NT 6.1; WOW64; rv:35.0) Gecko/20100101 Firefox/35.0\"",
+				(unsigned long)uiTime, uiMillis, uiTaken, cstrClient, cstrRemote, uiPort, cstrAction, uiStatus, uiBytes, cstrHost, cstrWord, uiImage, cstrHost);
+}
+
+static void generateFortiGate1K5(logGenerator* pGen, char* cstrLine) {
+	char cstrDate[16], cstrTime[16], cstrSrc[16], cstrDst[16];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrDate, sizeof(cstrDate), "%Y-%m-%d", uiTime);
+	pGen->getTime(cstrTime, sizeof(cstrTime), "%H:%M:%S", uiTime);
+	pGen->getIP(cstrDst, sizeof(cstrDst), false);
+	u_int32_t uiDPort = (pGen->next(4) ? 80 : 443);
+	const char* cstrHost = GEN_PICK(GEN_HOSTS, pGen->next());
+	u_int32_t uiRcvd = pGen->next(100000);
+	const char* cstrReferrer = GEN_PICK(GEN_HOSTS, pGen->next());
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiSent = pGen->next(4000);
+	u_int32_t uiSession = pGen->next(100000000);
+	pGen->getIP(cstrSrc, sizeof(cstrSrc), true);
+	u_int32_t uiSPort = 1024 + pGen->next(60000);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "\"itime=%lu\",\"date=%s\",\"time=%s\",\"devid=FG1K5D3I16804933\",\"vd=root\",\"type=\"\"utm\"\"\",\"subtype=\"\"webfilter\"\"\",\"action=\"\"passthrough\"\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\","
+				"\"cat=52\",\"catdesc=\"\"Information Technology\"\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"\",\"devname=FG1Kcopper\",\"direction=\"\"outgoing\"\"\",\"\",\"dstintf=\"\"port26\"\"\",\"dstintfrole=\"\"undefined\"\"\","
+				"\"dstip=%s\",\"dstport=%u\",\"dtime=%lu\",\"\",\"eventtype=\"\"ftgd_allow\"\"\",\"\",\"\",\"hostname=\"\"%s\"\"\",\"\",\"\",\"\",\"level=\"\"notice\"\"\",\"logid=\"\"0317013312\"\"\",\"logtime=%lu\",\"logver=56\","
+				"\"method=\"\"domain\"\"\",\"msg=\"\"URL belongs to an allowed category in policy\"\"\",\"policyid=1\",\"\",\"\",\"profile=\"\"NTC_Web_CTA\"\"\",\"proto=6\",\"rcvdbyte=%u\",\"\",\"\","
+				"\"referralurl=\"\"http://%s/%s.html\"\"\",\"reqtype=\"\"referral\"\"\",\"\",\"sentbyte=%u\",\"\",\"service=\"\"HTTP\"\"\",\"sessionid=%u\",\"\",\"\",\"srcintf=\"\"port17\"\"\",\"srcintfrole=\"\"undefined\"\"\","
+				"\"srcip=%s\",\"srcport=%u\"",
+				(unsigned long)uiTime, cstrDate, cstrTime, cstrDst, uiDPort, (unsigned long)uiTime - 21600, cstrHost, (unsigned long)uiTime, uiRcvd, cstrReferrer, cstrWord, uiSent, uiSession, cstrSrc, uiSPort);
+}
+
+// Rotates through connection build/teardown and ACL messages that the built-in PIX programs decode
+static void generatePIX(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrDevice[48], cstrSrc[16], cstrDst[16];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrTime, sizeof(cstrTime), "%b %d %H:%M:%S", uiTime);
+	pGen->getTime(cstrDevice, sizeof(cstrDevice), "%b %d %Y %H:%M:%S", uiTime);
+	pGen->getIP(cstrSrc, sizeof(cstrSrc), true);
+	pGen->getIP(cstrDst, sizeof(cstrDst), false);
+	u_int32_t uiSPort = 1024 + pGen->next(60000);
+	u_int32_t uiDPort = (pGen->next(4) ? 80 : 443);
+	u_int32_t uiConn = pGen->next(1000000);
+	u_int32_t uiDuration = pGen->next(60);
+	u_int32_t uiBytes = pGen->next(500000);
+
+	int n = snprintf(cstrLine, LOG_GENERATOR_LINE, "%s 10.0.0.1 %s: ", cstrTime, cstrDevice);
+	switch (pGen->next(4)) {
+		case 0:
+			snprintf(cstrLine + n, LOG_GENERATOR_LINE - n, "%%ASA-6-302013: Built outbound TCP connection %u for outside:%s/%u (%s/%u) to inside:%s/%u (%s/%u)", uiConn, cstrDst, uiDPort, cstrDst, uiDPort, cstrSrc, uiSPort, cstrSrc, uiSPort);
+			break;
+		case 1:
+			snprintf(cstrLine + n, LOG_GENERATOR_LINE - n, "%%ASA-6-302014: Teardown TCP connection %u for outside:%s/%u to inside:%s/%u duration 0:00:%02u bytes %u TCP FINs", uiConn, cstrDst, uiDPort, cstrSrc, uiSPort, uiDuration, uiBytes);
+			break;
+		case 2:
+			snprintf(cstrLine + n, LOG_GENERATOR_LINE - n, "%%ASA-4-106023: Deny tcp src outside:%s/%u dst inside:%s/%u by access-group \"outside_access_in\" [0x0, 0x0]", cstrDst, uiDPort, cstrSrc, uiSPort);
+			break;
+		default:
+			snprintf(cstrLine + n, LOG_GENERATOR_LINE - n, "%%PIX-6-106100: access-list inside_access_out permitted tcp inside/%s(%u) -> outside/%s(%u) hit-cnt 1 first hit [0x0, 0x0]", cstrSrc, uiSPort, cstrDst, uiDPort);
+			break;
+	}
+}
+
+static void generateJuniper(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrStart[48], cstrSrc[16], cstrDst[16];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrTime, sizeof(cstrTime), "%b %d %H:%M:%S", uiTime);
+	pGen->getTime(cstrStart, sizeof(cstrStart), "%Y-%m-%d %H:%M:%S", uiTime);
+	u_int32_t uiDuration = pGen->next(120);
+	bool bHTTPS = !pGen->next(4);
+	u_int32_t uiSent = pGen->next(20000);
+	u_int32_t uiRcvd = pGen->next(500000);
+	pGen->getIP(cstrSrc, sizeof(cstrSrc), true);
+	pGen->getIP(cstrDst, sizeof(cstrDst), false);
+	u_int32_t uiSPort = 1024 + pGen->next(60000);
+	u_int32_t uiXPort = 1024 + pGen->next(60000);
+	u_int32_t uiSession = pGen->next(100000);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s 10.0.0.1 ns5gt: NetScreen device_id=ns5gt  [Root]system-notification-00257(traffic): start_time=\"%s\" duration=%u policy_id=1 service=%s proto=6 src zone=Trust dst zone=Untrust "
+				"action=Permit sent=%u rcvd=%u src=%s dst=%s src_port=%u dst_port=%u src-xlated ip=1.2.3.4 port=%u session_id=%u reason=Close - TCP FIN",
+				cstrTime, cstrStart, uiDuration, (bHTTPS ? "https" : "http"), uiSent, uiRcvd, cstrSrc, cstrDst, uiSPort, (bHTTPS ? 443 : 80), uiXPort, uiSession);
+}
+
+// The year comes from multi2mactime --year (2017)
+static void generateSymantec(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrSrc[16], cstrDst[16];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrTime, sizeof(cstrTime), "%b %d %H:%M:%S", uiTime);
+	u_int32_t uiMillis = pGen->next(1000);
+	u_int32_t uiPID = 1000 + pGen->next(30000);
+	u_int32_t uiDuration = pGen->next(3000);
+	u_int32_t uiSent = pGen->next(20000);
+	u_int32_t uiRcvd = pGen->next(500000);
+	pGen->getIP(cstrSrc, sizeof(cstrSrc), true);
+	u_int32_t uiSPort = 1024 + pGen->next(60000);
+	pGen->getIP(cstrDst, sizeof(cstrDst), false);
+	u_int32_t uiDPort = (pGen->next(4) ? 80 : 443);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s.%03u fw1 httpd[%u]: 121 Statistics: duration=%u.%02u sent=%u rcvd=%u src=%s/%u dst=%s/%u cache_hit=0 proxy_id=HTTP operation=GET",
+				cstrTime, uiMillis, uiPID, uiDuration / 100, uiDuration % 100, uiSent, uiRcvd, cstrSrc, uiSPort, cstrDst, uiDPort);
+}
+
+static void generateHirsch(logGenerator* pGen, char* cstrLine) {
+	char cstrHost[48], cstrController[48];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime12(cstrHost, sizeof(cstrHost), uiTime, true);
+	pGen->getTime12(cstrController, sizeof(cstrController), uiTime + 1, true);
+	u_int32_t uiSequence = pGen->next(1000000);
+	const char* cstrDescription = (pGen->next(2) ? "Updating temporary users" : "Access granted");
+	u_int32_t uiEvent = 8000 + pGen->next(100);
+	u_int32_t uiDoor = 1 + pGen->next(16);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "\"   Host Date/Time BETWEEN '2017-08-23 00:00:00' AND '2017-08-25 23:59:59'   \",\"SITE\",\"All Events Log By Date\",\"Print Time:\",\"8/30/2017\",\"12:07:07PM\",\"Printed by:\",\"USER\","
+				"\"Sequence ID\",\"Host Date/Time\",\"Controller Date/Time\",\"Description\",\"Event ID\",\"Address\",%u,\"%s\",\"%s\",\"%s\",%u,\"\\\\XNET.001.0004.001.%02u\",\"Page -1 of 1\"",
+				uiSequence, cstrHost, cstrController, cstrDescription, uiEvent, uiDoor);
+}
+
+static void generateCustFSBT(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrIP[16], cstrHash[48];
+	pGen->getTime12(cstrTime, sizeof(cstrTime), pGen->nextTime());
+	pGen->getIP(cstrIP, sizeof(cstrIP), false);
+	u_int32_t uiPort = 1024 + pGen->next(60000);
+	pGen->getHex(cstrHash, sizeof(cstrHash), 5, false);
+	u_int32_t uiSeverity = 1 + pGen->next(5);
+	u_int32_t uiCount = 1 + pGen->next(100);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s\t%s :%u\t%s\t%u\t%u", cstrTime, cstrIP, uiPort, cstrHash, uiSeverity, uiCount);
+}
+
+static void generateCustFSEM(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrIP[16], cstrHash[48];
+	pGen->getTime12(cstrTime, sizeof(cstrTime), pGen->nextTime());
+	pGen->getIP(cstrIP, sizeof(cstrIP), false);
+	u_int32_t uiPort = 1024 + pGen->next(60000);
+	pGen->getHex(cstrHash, sizeof(cstrHash), 4, true);
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiFile = pGen->next(1000);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s\t%s :%u\t%s\t%s_%u.avi", cstrTime, cstrIP, uiPort, cstrHash, cstrWord, uiFile);
+}
+
+static void generateCusVPNS1(logGenerator* pGen, char* cstrLine) {
+	char cstrDate[16], cstrTime[16], cstrSrc[16], cstrDst[16];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrDate, sizeof(cstrDate), "%m/%d/%y", uiTime);
+	pGen->getTime(cstrTime, sizeof(cstrTime), "%H:%M:%S", uiTime);
+	const char* cstrUser = GEN_PICK(GEN_USERS, pGen->next());
+	pGen->getIP(cstrSrc, sizeof(cstrSrc), false);
+	pGen->getIP(cstrDst, sizeof(cstrDst), true);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s,%s,%s,%s,%s", cstrDate, cstrTime, cstrUser, cstrSrc, cstrDst);
+}
+
+static void generateGriffeye(logGenerator* pGen, char* cstrLine) {
+	char cstrHash[48], cstrB[48], cstrA[48], cstrM[48], cstrC[48];
+	time_t uiTime = pGen->nextTime();
+	pGen->getHex(cstrHash, sizeof(cstrHash), 4, false);
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiFile = pGen->next(10000);
+	const char* cstrUser = GEN_PICK(GEN_USERS, pGen->next());
+	const char* cstrCategory = GEN_PICK(GEN_CATEGORIES, pGen->next());
+	u_int32_t uiSize = 10000 + pGen->next(5000000);
+	pGen->getTime12(cstrB, sizeof(cstrB), uiTime);
+	pGen->getTime12(cstrA, sizeof(cstrA), uiTime + pGen->next(86400));
+	pGen->getTime12(cstrM, sizeof(cstrM), uiTime + 60);
+	pGen->getTime12(cstrC, sizeof(cstrC), uiTime - pGen->next(86400));
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s,\"%s_%u.jpg\",\"C:\\Users\\%s\\Pictures\",,%s,%u,%s,%s,%s,%s", cstrHash, cstrWord, uiFile, cstrUser, cstrCategory, uiSize, cstrB, cstrA, cstrM, cstrC);
+}
+
+static void generateIEF(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrSession[48];
+	time_t uiTime = pGen->nextTime();
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiTerm = pGen->next(100);
+	pGen->getTime12(cstrTime, sizeof(cstrTime), uiTime);
+	pGen->getTime12(cstrSession, sizeof(cstrSession), uiTime - pGen->next(600));
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s %u,%s,\"%s %u - Google Search\",https://www.google.com/search?q=%s+%u,%s,%s", cstrWord, uiTerm, cstrWord, cstrWord, uiTerm, cstrWord, uiTerm, cstrTime, cstrSession);
+}
+
+static void generateNotes(logGenerator* pGen, char* cstrLine) {
+	char cstrTime[48], cstrFrom[16], cstrTo[16];
+	pGen->getTime12(cstrTime, sizeof(cstrTime), pGen->nextTime());
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	const char* cstrUser = GEN_PICK(GEN_USERS, pGen->next());
+	pGen->getIP(cstrFrom, sizeof(cstrFrom), true);
+	pGen->getIP(cstrTo, sizeof(cstrTo), false);
+	const char* cstrNote = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiNote = pGen->next(1000);
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s,email,\"Sent %s.docx to %s\",mail.pst,%s,%s,\"Follow up on %s %u\"", cstrTime, cstrWord, cstrUser, cstrFrom, cstrTo, cstrNote, uiNote);
+}
+
+static void generateExifTool(logGenerator* pGen, char* cstrLine) {
+	char cstrModify[48], cstrMetadata[48], cstrCreate[48];
+	time_t uiTime = pGen->nextTime();
+	pGen->getTime(cstrModify, sizeof(cstrModify), "%Y:%m:%d %H:%M:%S", uiTime + 3600);
+	pGen->getTime(cstrMetadata, sizeof(cstrMetadata), "%Y:%m:%d %H:%M:%S", uiTime + 3660);
+	pGen->getTime(cstrCreate, sizeof(cstrCreate), "%Y:%m:%d %H:%M:%S", uiTime);
+	const char* cstrWord = GEN_PICK(GEN_WORDS, pGen->next());
+	u_int32_t uiFile = pGen->next(10000);
+	const char* cstrAuthor = GEN_PICK(GEN_USERS, pGen->next());
+	const char* cstrCreator = GEN_PICK(GEN_USERS, pGen->next());
+	snprintf(cstrLine, LOG_GENERATOR_LINE, "%s_%u.pdf,%s,Example Inc,\"%s\",,,%s,Microsoft Word 2016,%s,%s,%s", cstrWord, uiFile, cstrAuthor, cstrWord, cstrCreator, cstrModify, cstrMetadata, cstrCreate);
+}
+
+static const struct {
+	const char* cstrType;
+	const char* cstrHeader;
+	void (*fnGenerate)(logGenerator*, char*);
+} LOG_GENERATORS[] = {
+	{"squidw3c",	NULL,	generateSquidW3c},
+	{"fortg1k5",	NULL,	generateFortiGate1K5},
+	{"pix",			NULL,	generatePIX},
+	{"juniper",		NULL,	generateJuniper},
+	{"symantec",	NULL,	generateSymantec},
+	{"hirsch",		NULL,	generateHirsch},
+	{"custfsbt",	NULL,	generateCustFSBT},
+	{"custfsem",	NULL,	generateCustFSEM},
+	{"cusvpns1",	"Date,Time,User,Source IP,Destination IP",	generateCusVPNS1},
+	{"griffeye",	"MD5,File Name,Directory Path,File Path,Category,File Size,Created Date,Last Accessed,Last Write Time,Exif: CreateDate",	generateGriffeye},
+	{"ief",			"Search Term,Original Search Query,Web Page Title,URL,Date/Time - (UTC) (MM/dd/yyyy),Search Session Start Date/Time - (UTC) (MM/dd/yyyy)",	generateIEF},
+	{"notes",		"Date/Time,Artifact,Details,Source,From,To,Notes",	generateNotes},
+	{"exiftool",	"FileName,Author,Company,Title,Subject,Description,Creator,CreatorTool,ModifyDate,MetadataDate,CreateDate",	generateExifTool},
+};
+
+bool generateLog(string strType, u_int64_t uiRows, u_int32_t uiSeed, ostream* pOutput) {
+	for (size_t i=0; i<sizeof(LOG_GENERATORS)/sizeof(LOG_GENERATORS[0]); i++) {
+		if (strType == LOG_GENERATORS[i].cstrType) {
+			logGenerator gen(uiSeed);
+			char cstrLine[LOG_GENERATOR_LINE];
+			if (LOG_GENERATORS[i].cstrHeader) {
+				*pOutput << LOG_GENERATORS[i].cstrHeader << "\n";
+			}
+			for (u_int64_t uiRow=0; uiRow<uiRows && *pOutput; uiRow++) {
+				LOG_GENERATORS[i].fnGenerate(&gen, cstrLine);
+				*pOutput << cstrLine << "\n";
+			}
+			return (bool)*pOutput;
+		}
+	}
+	ERROR("generateLog() Unknown type (" << strType << ")");
+	return false;
+}
+
+string getLogFilename(string strType) {
+	return (strType == "ief" ? "Google Searches.csv" : strType + ".log");
+}
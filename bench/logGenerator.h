@@ -0,0 +1,35 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_BENCH_LOGGENERATOR_H_
+#define MULTI2MACTIME_BENCH_LOGGENERATOR_H_
+
+#include <string>
+#include <ostream>
+using namespace std;
+
+// Synthetic input for each multi2mactime --type, modelled on the sample lines in the parsers. Output depends only on
+// the type, row count and seed (raw mt19937 values, no std:: distributions whose results vary between libraries), so
+// runs on different machines or builds read the same bytes. Times start at 2017-08-25 00:00:00 UTC and advance a few
+// seconds per row, so the data is also valid --ordered/--merge-sorted input. Header based types (griffeye, ief, notes,
+// exiftool) get their header row in addition to the requested rows; ief data is the "Google Searches" artifact, which
+// multi2mactime identifies by the file name returned from getLogFilename().
+
+extern const char* LOG_GENERATOR_TYPES[];
+extern const size_t LOG_GENERATOR_TYPE_COUNT;
+
+bool generateLog(string strType, u_int64_t uiRows, u_int32_t uiSeed, ostream* pOutput);
+string getLogFilename(string strType);
+
+#endif /*MULTI2MACTIME_BENCH_LOGGENERATOR_H_*/
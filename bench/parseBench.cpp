@@ -0,0 +1,211 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generates synthetic input for each parser (logGenerator.h), runs multi2mactime over it and reports input MB/s and
+// rows/s per --type. Each run is timed end to end (process start, parse, body output to a file), best of --runs, so
+// the numbers include everything a user would wait for. The output row count is shown so a parser that silently
+// stops producing rows stands out.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+using namespace std;
+
+#include "popt.h"
+#include "misc/poptUtils.h"
+#include "logGenerator.h"
+
+#define PARSEBENCH_DEFAULT_ROWS	200000
+#define PARSEBENCH_DEFAULT_RUNS	3
+
+// Quotes a path for /bin/sh
+static string getShellQuoted(const string& strValue) {
+	string rv = "'";
+	for (string::const_iterator it = strValue.begin(); it != strValue.end(); it++) {
+		rv += (*it == '\'' ? string("'\\''") : string(1, *it));
+	}
+	return rv + "'";
+}
+
+static u_int64_t getFileSize(const string& strFilename) {
+	struct stat st;
+	return (stat(strFilename.c_str(), &st) == 0 ? st.st_size : 0);
+}
+
+static u_int64_t getLineCount(const string& strFilename) {
+	u_int64_t rv = 0;
+	FILE* pFile = fopen(strFilename.c_str(), "r");
+	if (pFile) {
+		char cstrBuffer[64 * 1024];
+		size_t uiRead;
+		while ((uiRead = fread(cstrBuffer, 1, sizeof(cstrBuffer), pFile)) > 0) {
+			for (size_t i=0; i<uiRead; i++) {
+				rv += (cstrBuffer[i] == '\n');
+			}
+		}
+		fclose(pFile);
+	}
+	return rv;
+}
+
+int main(int argc, const char** argv) {
+	int rv = EXIT_SUCCESS;
+
+	u_int64_t uiRows = PARSEBENCH_DEFAULT_ROWS;
+	u_int32_t uiSeed = 1;
+	int iRuns = PARSEBENCH_DEFAULT_RUNS;
+	string strProgram = "../src/multi2mactime";
+	string strDirectory = "";
+
+	struct poptOption optionsTable[] = {
+		{"rows",			'r',	POPT_ARG_STRING,	NULL,	10,	"Rows to generate per type. Defaults to 200000.", "rows"},
+		{"seed",			 0,	POPT_ARG_INT,		NULL,	20,	"Random seed for the generated data. Defaults to 1.", "seed"},
+		{"runs",			 0,	POPT_ARG_INT,		NULL,	30,	"Runs per type; the fastest is reported. Defaults to 3.", "runs"},
+		{"multi2mactime",0,	POPT_ARG_STRING,	NULL,	40,	"multi2mactime binary to run. Defaults to ../src/multi2mactime.", "file"},
+		{"dir",			 0,	POPT_ARG_STRING,	NULL,	50,	"Directory for the generated data and output, which is kept. Defaults to a temporary directory that is removed.", "dir"},
+		{"version",		 0,	POPT_ARG_NONE,		NULL,	100,	"Display version.", NULL},
+		POPT_AUTOHELP
+		POPT_TABLEEND
+	};
+	poptContext optCon = poptGetContext(NULL, argc, argv, optionsTable, 0);
+	poptSetOtherOptionHelp(optCon, "[options] [type ...]");
+
+	int iOption = poptGetNextOpt(optCon);
+	while (iOption >= 0) {
+		switch (iOption) {
+			case 10:
+				uiRows = strtoull(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 20:
+				uiSeed = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 30:
+				iRuns = strtol(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 40:
+				strProgram = poptGetOptArg(optCon);
+				break;
+			case 50:
+				strDirectory = poptGetOptArg(optCon);
+				break;
+			case 100:
+				version(PACKAGE, VERSION);
+				exit(EXIT_SUCCESS);
+				break;
+		}
+		iOption = poptGetNextOpt(optCon);
+	}
+
+	if (iOption != -1) {
+		usage(optCon, poptBadOption(optCon, POPT_BADOPTION_NOALIAS), poptStrerror(iOption));
+		exit(EXIT_FAILURE);
+	}
+
+	vector<string> vecTypes;
+	const char* cstrType;
+	while ((cstrType = poptGetArg(optCon)) != NULL) {
+		vecTypes.push_back(cstrType);
+	}
+	if (vecTypes.empty()) {
+		vecTypes.assign(LOG_GENERATOR_TYPES, LOG_GENERATOR_TYPES + LOG_GENERATOR_TYPE_COUNT);
+	}
+	iRuns = (iRuns > 0 ? iRuns : 1);
+
+	char* cstrProgram = realpath(strProgram.c_str(), NULL);
+	if (!cstrProgram) {
+		ERROR("Unable to find " << strProgram);
+		exit(EXIT_FAILURE);
+	}
+	strProgram = cstrProgram;
+	free(cstrProgram);
+
+	bool bTemporary = (strDirectory == "");
+	if (bTemporary) {
+		const char* cstrTemp = getenv("TMPDIR");
+		char cstrTemplate[1024];
+		snprintf(cstrTemplate, sizeof(cstrTemplate), "%s/parseBench.XXXXXX", (cstrTemp && *cstrTemp ? cstrTemp : "/tmp"));
+		if (!mkdtemp(cstrTemplate)) {
+			ERROR("Unable to create a temporary directory (" << cstrTemplate << ")");
+			exit(EXIT_FAILURE);
+		}
+		strDirectory = cstrTemplate;
+	} else {
+		mkdir(strDirectory.c_str(), 0777);
+	}
+
+	cout << left << setw(10) << "type" << right << setw(10) << "MB" << setw(12) << "rows" << setw(12) << "out-rows" << setw(10) << "seconds" << setw(10) << "MB/s" << setw(12) << "rows/s" << "\n";
+
+	for (vector<string>::const_iterator it = vecTypes.begin(); it != vecTypes.end(); it++) {
+		string strInput = strDirectory + "/" + getLogFilename(*it);
+		string strOutput = strDirectory + "/" + *it + ".body";
+
+		ofstream fileInput(strInput.c_str());
+		if (!generateLog(*it, uiRows, uiSeed, &fileInput)) {
+			rv = EXIT_FAILURE;
+			continue;
+		}
+		fileInput.close();
+
+		// Run from the data directory: ief identifies the artifact by the bare file name. Symantec lines carry no year;
+		// the generated data is from 2017.
+		string strCommand = "cd " + getShellQuoted(strDirectory) + " && " + getShellQuoted(strProgram) + " -t " + getShellQuoted(*it) + (*it == "symantec" ? " -y 2017" : "") + " " +
+									getShellQuoted(getLogFilename(*it)) + " > " + getShellQuoted(*it + ".body") + " 2> /dev/null";
+		DEBUG("Running " << strCommand);
+
+		double dBest = 0;
+		for (int i=0; i<iRuns; i++) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			int iStatus = system(strCommand.c_str());
+			double dSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			// multi2mactime exits 1 on success as well; only a failure to run at all (127/signals) is fatal here
+			if (iStatus == -1 || !WIFEXITED(iStatus) || WEXITSTATUS(iStatus) > 1) {
+				ERROR(*it << ": Unable to run " << strProgram << " (status " << iStatus << ")");
+				rv = EXIT_FAILURE;
+				dBest = 0;
+				break;
+			}
+			dBest = (i == 0 || dSeconds < dBest ? dSeconds : dBest);
+		}
+
+		if (dBest > 0) {
+			double dMB = getFileSize(strInput) / 1e6;
+			cout << left << setw(10) << *it << right << fixed << setprecision(1) << setw(10) << dMB << setw(12) << uiRows << setw(12) << getLineCount(strOutput)
+					<< setprecision(3) << setw(10) << dBest << setprecision(1) << setw(10) << dMB / dBest << setprecision(0) << setw(12) << uiRows / dBest << "\n" << flush;
+		}
+
+		if (bTemporary) {
+			unlink(strInput.c_str());
+			unlink(strOutput.c_str());
+		}
+	}
+
+	if (bTemporary) {
+		rmdir(strDirectory.c_str());
+	}
+
+	poptFreeContext(optCon);
+	return rv;
+}
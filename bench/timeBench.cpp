@@ -0,0 +1,196 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the per-call cost of the timestamp helpers in processor.cpp (getUnix32FromStrings(),
+// getUnix32DateTimeFromString(), getUnix32DateTimeFromString2()) and of the format string createLocalTime() that the
+// syslog parsers use, in GMT and in a DST zone, for:
+//
+//		hot			the same valid timestamp every call (a log burst within one second)
+//		random		valid timestamps spread over 2000-2030, cycling through more than fit in the caches
+//		malformed	out of range or non-numeric values, i.e. the error path (messages go to /dev/null via logOpen())
+//
+// The valid column is the fraction of calls that produced a time, as a check that each case exercises the intended path.
+
+#include "misc/errMsgs.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <ctime>
+using namespace std;
+
+#include "processor.h"
+#include "libtimeUtils/src/timeZoneCalculator.h"
+#include "libtimeUtils/src/timeUtils.h"
+
+#define BENCH_ITERATIONS	200000
+#define BENCH_INPUTS			8192
+#define BENCH_SEED			1
+#define BENCH_TIME_START	946684800		// 2000-01-01 00:00:00 UTC
+#define BENCH_TIME_SPAN		978307200		// through 2030
+
+static const struct {
+	const char* cstrName;
+	const char* cstrZone;
+} BENCH_ZONES[] = {
+	{"GMT",		"GMT"},
+	{"EST5EDT",	"EST-5EDT,M3.2.0,M11.1.0"},
+};
+
+#define BENCH_HOT			0
+#define BENCH_RANDOM		1
+#define BENCH_MALFORMED	2
+
+static const char* BENCH_INPUT_NAMES[] = { "hot", "random", "malformed" };
+
+// The component strings getUnix32FromStrings() is called with, and the same time formatted for each of the other helpers
+struct benchTime {
+	string strFields[6];				// month, day, year, hour, minute, second
+	string strDateTime;				// M/D/YYYY H:MM:SS AM|PM
+	string strDateTime2;				// YYYY-MM-DD HH:MM:SS
+	string strSyslog;					// Mmm dd yyyy hh:mm:ss
+};
+
+static volatile int32_t iSink;
+
+static benchTime getBenchTime(time_t uiTime, int iMalformed) {
+	struct tm tmTime;
+	gmtime_r(&uiTime, &tmTime);
+
+	// Each malformed kind breaks a different part of the value
+	int iMonth = tmTime.tm_mon + 1;
+	int iDay = tmTime.tm_mday;
+	int iHour = tmTime.tm_hour;
+	string strMinute = to_string(tmTime.tm_min);
+	switch (iMalformed) {
+		case 1:
+			iMonth = 13;
+			break;
+		case 2:
+			iDay = 32;
+			break;
+		case 3:
+			iHour = 25;
+			break;
+		case 4:
+			strMinute = "x" + strMinute;
+			break;
+	}
+
+	benchTime rv;
+	rv.strFields[0] = to_string(iMonth);
+	rv.strFields[1] = to_string(iDay);
+	rv.strFields[2] = to_string(tmTime.tm_year + 1900);
+	rv.strFields[3] = to_string(iHour);
+	rv.strFields[4] = strMinute;
+	rv.strFields[5] = to_string(tmTime.tm_sec);
+
+	static const char* MONTHS[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec", "Xyz" };
+	char cstrTime[64];
+	snprintf(cstrTime, sizeof(cstrTime), "%d/%d/%d %d:%s:%02d %s", iMonth, iDay, tmTime.tm_year + 1900, (iHour % 12 ? iHour % 12 : 12), strMinute.c_str(), tmTime.tm_sec, (iHour < 12 ? "AM" : "PM"));
+	rv.strDateTime = cstrTime;
+	snprintf(cstrTime, sizeof(cstrTime), "%d-%02d-%02d %02d:%s:%02d", tmTime.tm_year + 1900, iMonth, iDay, iHour, strMinute.c_str(), tmTime.tm_sec);
+	rv.strDateTime2 = cstrTime;
+	snprintf(cstrTime, sizeof(cstrTime), "%s %02d %d %02d:%s:%02d", MONTHS[iMonth - 1], iDay, tmTime.tm_year + 1900, iHour, strMinute.c_str(), tmTime.tm_sec);
+	rv.strSyslog = cstrTime;
+	return rv;
+}
+
+static vector<benchTime> getBenchInputs(int iInput) {
+	vector<benchTime> rv;
+	mt19937 rng(BENCH_SEED);
+	size_t uiCount = (iInput == BENCH_HOT ? 1 : BENCH_INPUTS);
+	for (size_t i=0; i<uiCount; i++) {
+		time_t uiTime = BENCH_TIME_START + rng() % BENCH_TIME_SPAN;
+		rv.push_back(getBenchTime(uiTime, (iInput == BENCH_MALFORMED ? 1 + i % 4 : 0)));
+	}
+	return rv;
+}
+
+// Returns ns per call; *pdValid is the fraction of calls that returned a time
+template <typename F> static double timeCalls(const vector<benchTime>& vecInputs, double* pdValid, F f) {
+	size_t uiValid = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i=0; i<BENCH_ITERATIONS; i++) {
+		int32_t timeVal = f(vecInputs[i % vecInputs.size()]);
+		uiValid += (timeVal > 0);
+		iSink += timeVal;
+	}
+	double rv = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+	*pdValid = (double)uiValid / BENCH_ITERATIONS;
+	return rv;
+}
+
+int main(int argc, const char** argv) {
+	// The malformed cases log an error per call; keep them off the terminal
+	logOpen("/dev/null");
+
+	vector<benchTime> vecInputs[3];
+	for (int i=0; i<3; i++) {
+		vecInputs[i] = getBenchInputs(i);
+	}
+
+	cout << left << setw(30) << "helper" << setw(10) << "zone" << setw(11) << "input" << right << setw(12) << "ns/call" << setw(9) << "valid" << "\n";
+
+	for (size_t z=0; z<sizeof(BENCH_ZONES)/sizeof(BENCH_ZONES[0]); z++) {
+		timeZoneCalculator tzcalc;
+		tzcalc.setTimeZone(BENCH_ZONES[z].cstrZone);
+
+		for (int iHelper=0; iHelper<4; iHelper++) {
+			for (int iInput=BENCH_HOT; iInput<=BENCH_MALFORMED; iInput++) {
+				double dValid = 0;
+				double dNanos = 0;
+				const char* cstrHelper = "";
+				switch (iHelper) {
+					case 0:
+						cstrHelper = "getUnix32FromStrings";
+						dNanos = timeCalls(vecInputs[iInput], &dValid, [&](const benchTime& t) {
+							return getUnix32FromStrings(t.strFields[0], t.strFields[1], t.strFields[2], t.strFields[3], t.strFields[4], t.strFields[5], 0, &tzcalc);
+						});
+						break;
+					case 1:
+						cstrHelper = "getUnix32DateTimeFromString";
+						dNanos = timeCalls(vecInputs[iInput], &dValid, [&](const benchTime& t) {
+							return getUnix32DateTimeFromString(t.strDateTime, ' ', '/', ':', 0, &tzcalc);
+						});
+						break;
+					case 2:
+						cstrHelper = "getUnix32DateTimeFromString2";
+						dNanos = timeCalls(vecInputs[iInput], &dValid, [&](const benchTime& t) {
+							return getUnix32DateTimeFromString2(t.strDateTime2, ' ', '-', ':', 0, &tzcalc);
+						});
+						break;
+					default:
+						// As processPIX() converts the device time
+						cstrHelper = "createLocalTime(format)";
+						dNanos = timeCalls(vecInputs[iInput], &dValid, [&](const benchTime& t) {
+							boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
+							return (tzcalc.createLocalTime(t.strSyslog, "%b %d %Y %H:%M:%S", &ldt) ? getUnix32FromLocalTime(ldt) : -1);
+						});
+						break;
+				}
+
+				cout << left << setw(30) << cstrHelper << setw(10) << BENCH_ZONES[z].cstrName << setw(11) << BENCH_INPUT_NAMES[iInput] << right << fixed
+						<< setprecision(1) << setw(12) << dNanos << setprecision(0) << setw(8) << dValid * 100 << "%\n" << flush;
+			}
+		}
+	}
+
+	logClose();
+	return 0;
+}
@@ -0,0 +1,314 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "bodySorter.h"
+#include "processor.h"
+#include "timeIndex.h"
+#include "spanTracer.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <ostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+using namespace std;
+
+bodySorter::bodySorter(string strTempDir, u_int64_t uiMemoryBudget) : m_strTempDir(strTempDir), m_uiMemoryBudget(uiMemoryBudget), m_bFailed(false) {
+	if (m_strTempDir == "") {
+		const char* cstrTemp = getenv("TMPDIR");
+		m_strTempDir = (cstrTemp && *cstrTemp ? cstrTemp : "/tmp");
+	}
+}
+
+bodySorter::~bodySorter() {
+	removeRuns();
+}
+
+#define BODYSORTER_INTERNED		2			// TYPE and LOG, which follow HASH and DETAIL
+
+bool bodySorter::add(string* strFields) {
+	if (m_bFailed) {
+		return false;
+	}
+
+	// formatBodyRow() has replaced any '|' within the fields, so the first delimiters split off HASH, DETAIL and the
+	// interned fields
+	formatBodyRow(strFields, &m_strRow);
+	size_t posDelims[2 + BODYSORTER_INTERNED];
+	for (int i=0; i<2 + BODYSORTER_INTERNED; i++) {
+		posDelims[i] = m_strRow.find('|', (i ? posDelims[i - 1] + 1 : 0));
+	}
+	u_int32_t uiIDs[BODYSORTER_INTERNED];
+	for (int i=0; i<BODYSORTER_INTERNED; i++) {
+		uiIDs[i] = m_table.intern(m_strRow.data() + posDelims[i + 1] + 1, posDelims[i + 2] - posDelims[i + 1] - 1);
+	}
+
+	sortRecord record = { getBodyRowTime(strFields), (u_int32_t)(sizeof(uiIDs) + m_strRow.length() - (posDelims[1 + BODYSORTER_INTERNED] - posDelims[1])), m_strBuffer.length() };
+	m_strBuffer.append((const char*)uiIDs, sizeof(uiIDs));
+	m_strBuffer.append(m_strRow, 0, posDelims[1] + 1);
+	m_strBuffer.append(m_strRow, posDelims[1 + BODYSORTER_INTERNED] + 1, string::npos);
+	m_vecRecords.push_back(record);
+
+	// Budget covers the row text, the interned values, the record array and the radix sort's scratch copy of it
+	if (m_strBuffer.length() + m_table.getMemory() + m_vecRecords.size() * sizeof(sortRecord) * 2 >= m_uiMemoryBudget) {
+		m_bFailed = !spillBuffer();
+	}
+	return !m_bFailed;
+}
+
+// Rebuilds the output row for a buffered record
+void bodySorter::getRow(const sortRecord& record, string* pstrRow) const {
+	u_int32_t uiIDs[BODYSORTER_INTERNED];
+	const char* pEntry = m_strBuffer.data() + record.uiOffset;
+	memcpy(uiIDs, pEntry, sizeof(uiIDs));
+	const char* pText = pEntry + sizeof(uiIDs);
+	size_t uiTextLength = record.uiLength - sizeof(uiIDs);
+	const char* pDelim = (const char*)memchr(pText, '|', uiTextLength);
+	const char* pDetailEnd = (const char*)memchr(pDelim + 1, '|', pText + uiTextLength - pDelim - 1) + 1;
+
+	pstrRow->assign(pText, pDetailEnd - pText);
+	for (int i=0; i<BODYSORTER_INTERNED; i++) {
+		m_table.appendString(uiIDs[i], pstrRow);
+		pstrRow->push_back('|');
+	}
+	pstrRow->append(pDetailEnd, pText + uiTextLength - pDetailEnd);
+}
+
+// LSD radix sort on the 32-bit time, one byte per pass; passes where every key has the same byte are skipped.
+void bodySorter::sortBuffer() {
+	size_t count = m_vecRecords.size();
+	m_vecScratch.resize(count);
+
+	for (int iShift=0; iShift<32; iShift+=8) {
+		size_t uiCounts[256];
+		memset(uiCounts, 0, sizeof(uiCounts));
+		for (size_t i=0; i<count; i++) {
+			uiCounts[(m_vecRecords[i].uiTime >> iShift) & 0xff]++;
+		}
+		if (uiCounts[(m_vecRecords[0].uiTime >> iShift) & 0xff] == count) {
+			continue;
+		}
+
+		size_t uiOffset = 0;
+		for (int i=0; i<256; i++) {
+			size_t uiCount = uiCounts[i];
+			uiCounts[i] = uiOffset;
+			uiOffset += uiCount;
+		}
+		for (size_t i=0; i<count; i++) {
+			m_vecScratch[uiCounts[(m_vecRecords[i].uiTime >> iShift) & 0xff]++] = m_vecRecords[i];
+		}
+		m_vecRecords.swap(m_vecScratch);
+	}
+}
+
+// Creates a temporary run file and adds it to m_vecRuns
+FILE* bodySorter::createRun() {
+	string strRun = m_strTempDir + "/multi2mactime.XXXXXX";
+	vector<char> vecRun(strRun.begin(), strRun.end());
+	vecRun.push_back('\0');
+	int fd = mkstemp(&vecRun[0]);
+	if (fd < 0) {
+		LOG_ERROR("bodySorter::createRun() Unable to create temporary file in " << m_strTempDir);
+		return NULL;
+	}
+	m_vecRuns.push_back(&vecRun[0]);
+	return fdopen(fd, "wb");
+}
+
+bool bodySorter::spillBuffer() {
+	if (m_vecRecords.empty()) {
+		return true;
+	}
+	traceSpan span("spill sorted run");
+	sortBuffer();
+
+	FILE* pRun = createRun();
+	if (!pRun) {
+		return false;
+	}
+	DEBUG("bodySorter::spillBuffer() " << m_vecRecords.size() << " rows to " << m_vecRuns.back());
+
+	bool rv = true;
+	for (vector<sortRecord>::const_iterator it = m_vecRecords.begin(); rv && it != m_vecRecords.end(); it++) {
+		getRow(*it, &m_strRow);
+		u_int32_t uiLength = m_strRow.length();
+		rv = (fwrite(&it->uiTime, sizeof(it->uiTime), 1, pRun) == 1 &&
+				fwrite(&uiLength, sizeof(uiLength), 1, pRun) == 1 &&
+				fwrite(m_strRow.data(), 1, uiLength, pRun) == uiLength);
+	}
+	if (fclose(pRun) != 0 || !rv) {
+		LOG_ERROR("bodySorter::spillBuffer() Unable to write temporary file " << m_vecRuns.back());
+		rv = false;
+	}
+
+	m_strBuffer.clear();
+	m_table.clear();
+	m_vecRecords.clear();
+	return rv;
+}
+
+void bodySorter::removeRuns() {
+	for (vector<string>::const_iterator it = m_vecRuns.begin(); it != m_vecRuns.end(); it++) {
+		if (*it != "") {
+			unlink(it->c_str());
+		}
+	}
+	m_vecRuns.clear();
+}
+
+// k-way merge of (*pvecRuns)[uiFirst, uiFirst + uiCount) to pOutput (and pIndex), or as a longer run to pRun. Heap
+// entries are (time, run) so ties resolve to the earlier run. The merged runs are removed.
+bool bodySorter::mergeRuns(vector<string>* pvecRuns, size_t uiFirst, size_t uiCount, size_t uiBuffer, ostream* pOutput, FILE* pRun, timeIndex* pIndex) {
+	bool rv = true;
+	vector<FILE*> vecFiles(uiCount, (FILE*)NULL);
+	vector<string> vecRows(uiCount);
+	priority_queue<pair<u_int32_t, size_t>, vector<pair<u_int32_t, size_t> >, greater<pair<u_int32_t, size_t> > > heap;
+
+	for (size_t i=0; rv && i<uiCount; i++) {
+		vecFiles[i] = fopen((*pvecRuns)[uiFirst + i].c_str(), "rb");
+		if (vecFiles[i]) {
+			setvbuf(vecFiles[i], NULL, _IOFBF, uiBuffer);
+			u_int32_t uiTime = 0, uiLength = 0;
+			if (fread(&uiTime, sizeof(uiTime), 1, vecFiles[i]) == 1 && fread(&uiLength, sizeof(uiLength), 1, vecFiles[i]) == 1) {
+				vecRows[i].resize(uiLength);
+				if (uiLength && fread(&vecRows[i][0], 1, uiLength, vecFiles[i]) != uiLength) {
+					LOG_ERROR("bodySorter::mergeRuns() Truncated temporary file " << (*pvecRuns)[uiFirst + i]);
+					rv = false;
+				}
+				heap.push(make_pair(uiTime, i));
+			}
+		} else {
+			LOG_ERROR("bodySorter::mergeRuns() Unable to open temporary file " << (*pvecRuns)[uiFirst + i]);
+			rv = false;
+		}
+	}
+
+	while (rv && !heap.empty()) {
+		u_int32_t uiRowTime = heap.top().first;
+		size_t i = heap.top().second;
+		heap.pop();
+		if (pRun) {
+			u_int32_t uiRowLength = vecRows[i].length();
+			rv = (fwrite(&uiRowTime, sizeof(uiRowTime), 1, pRun) == 1 &&
+					fwrite(&uiRowLength, sizeof(uiRowLength), 1, pRun) == 1 &&
+					fwrite(vecRows[i].data(), 1, uiRowLength, pRun) == uiRowLength);
+			if (!rv) {
+				LOG_ERROR("bodySorter::mergeRuns() Unable to write temporary file " << m_vecRuns.back());
+			}
+		} else {
+			pOutput->write(vecRows[i].data(), vecRows[i].length());
+			if (pIndex) {
+				pIndex->addRow(uiRowTime, vecRows[i].length());
+			}
+		}
+
+		u_int32_t uiTime = 0, uiLength = 0;
+		if (fread(&uiTime, sizeof(uiTime), 1, vecFiles[i]) == 1 && fread(&uiLength, sizeof(uiLength), 1, vecFiles[i]) == 1) {
+			vecRows[i].resize(uiLength);
+			if (uiLength && fread(&vecRows[i][0], 1, uiLength, vecFiles[i]) != uiLength) {
+				LOG_ERROR("bodySorter::mergeRuns() Truncated temporary file " << (*pvecRuns)[uiFirst + i]);
+				rv = false;
+			}
+			heap.push(make_pair(uiTime, i));
+		}
+	}
+
+	for (size_t i=0; i<uiCount; i++) {
+		if (vecFiles[i]) {
+			fclose(vecFiles[i]);
+		}
+		unlink((*pvecRuns)[uiFirst + i].c_str());
+		(*pvecRuns)[uiFirst + i] = "";
+	}
+
+	return rv;
+}
+
+bool bodySorter::finish(ostream* pOutput, timeIndex* pIndex) {
+	if (m_bFailed) {
+		return false;
+	}
+
+	// Everything fit in memory
+	if (m_vecRuns.empty()) {
+		if (m_vecRecords.size()) {
+			sortBuffer();
+		}
+		for (vector<sortRecord>::const_iterator it = m_vecRecords.begin(); it != m_vecRecords.end(); it++) {
+			getRow(*it, &m_strRow);
+			pOutput->write(m_strRow.data(), m_strRow.length());
+			if (pIndex) {
+				pIndex->addRow(it->uiTime, m_strRow.length());
+			}
+		}
+		m_strBuffer.clear();
+		m_table.clear();
+		m_vecRecords.clear();
+		return true;
+	}
+
+	if (!spillBuffer()) {
+		return false;
+	}
+	// The merge's read buffers come out of the same budget
+	string().swap(m_strBuffer);
+	vector<sortRecord>().swap(m_vecRecords);
+	vector<sortRecord>().swap(m_vecScratch);
+
+	size_t uiFanIn = (m_vecRuns.size() < BODYSORTER_MAX_FANIN ? m_vecRuns.size() : BODYSORTER_MAX_FANIN);
+	size_t uiBuffer = m_uiMemoryBudget / (uiFanIn + 1);
+	uiBuffer = (uiBuffer < BODYSORTER_MIN_IO_BUFFER ? BODYSORTER_MIN_IO_BUFFER : (uiBuffer > BODYSORTER_MAX_IO_BUFFER ? BODYSORTER_MAX_IO_BUFFER : uiBuffer));
+
+	// Intermediate passes merge consecutive groups, so the runs stay in input order and the merge stays stable
+	while (m_vecRuns.size() > BODYSORTER_MAX_FANIN) {
+		traceSpan span("merge pass");
+		DEBUG("bodySorter::finish() Merging " << m_vecRuns.size() << " runs in groups of " << BODYSORTER_MAX_FANIN);
+		vector<string> vecPass;
+		vecPass.swap(m_vecRuns);
+		for (size_t i=0; i<vecPass.size(); i+=BODYSORTER_MAX_FANIN) {
+			size_t uiCount = (vecPass.size() - i < BODYSORTER_MAX_FANIN ? vecPass.size() - i : BODYSORTER_MAX_FANIN);
+			FILE* pRun = createRun();
+			bool rv = (pRun != NULL);
+			if (rv) {
+				setvbuf(pRun, NULL, _IOFBF, uiBuffer);
+				rv = mergeRuns(&vecPass, i, uiCount, uiBuffer, NULL, pRun, NULL);
+				if (fclose(pRun) != 0 && rv) {
+					LOG_ERROR("bodySorter::finish() Unable to write temporary file " << m_vecRuns.back());
+					rv = false;
+				}
+			}
+			if (!rv) {
+				m_vecRuns.insert(m_vecRuns.end(), vecPass.begin(), vecPass.end());
+				removeRuns();
+				return false;
+			}
+		}
+	}
+
+	DEBUG("bodySorter::finish() Merging " << m_vecRuns.size() << " runs");
+	bool rv = mergeRuns(&m_vecRuns, 0, m_vecRuns.size(), uiBuffer, pOutput, NULL, pIndex);
+	removeRuns();
+
+	return rv;
+}
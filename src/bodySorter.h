@@ -0,0 +1,86 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_BODYSORTER_H_
+#define MULTI2MACTIME_BODYSORTER_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdio>
+using namespace std;
+
+#include "stringTable.h"
+
+class timeIndex;
+
+// External merge sort of output rows (--sort). Rows are keyed by getBodyRowTime() and buffered until the memory budget
+// is reached; the buffer is then ordered with an LSD radix sort on the key and spilled to a run file in the temporary
+// directory. While buffered, a row's TYPE and LOG-SRC, which repeat from row to row, are held as ids in a stringTable
+// that is cleared with each spill, and the row is rebuilt when it is written. FROM/TO stay inline: with ports they are
+// mostly distinct, and an interned value that does not repeat costs more than the text. finish() merges the runs (or
+// writes the buffer directly if nothing was spilled) through a heap. Both the radix sort and the merge are stable, so
+// rows with the same time keep their input order.
+//
+// At most BODYSORTER_MAX_FANIN runs are open at once; with more, consecutive groups of runs are first merged into
+// longer runs, in as many passes as it takes. Each open run gets an equal share of the memory budget as its read
+// buffer (between BODYSORTER_MIN_IO_BUFFER and BODYSORTER_MAX_IO_BUFFER).
+//
+// finish() can also record each row it writes in a timeIndex (--index).
+//
+// Run files hold records of [u_int32_t time][u_int32_t length][row text] and are removed as soon as they are merged.
+
+#define BODYSORTER_DEFAULT_MEMORY	256		// MB
+#define BODYSORTER_MAX_FANIN			64
+#define BODYSORTER_MIN_IO_BUFFER		(64 * 1024)
+#define BODYSORTER_MAX_IO_BUFFER		(1024 * 1024)
+
+class bodySorter {
+	public:
+		bodySorter(string strTempDir, u_int64_t uiMemoryBudget);
+		~bodySorter();
+
+		bool add(string* strFields);
+		bool finish(ostream* pOutput, timeIndex* pIndex = NULL);
+
+	private:
+		struct sortRecord {
+			u_int32_t uiTime;
+			u_int32_t uiLength;
+			u_int64_t uiOffset;
+		};
+
+		bodySorter(const bodySorter&);
+		bodySorter& operator=(const bodySorter&);
+
+		void getRow(const sortRecord& record, string* pstrRow) const;
+		void sortBuffer();
+		FILE* createRun();
+		bool spillBuffer();
+		bool mergeRuns(vector<string>* pvecRuns, size_t uiFirst, size_t uiCount, size_t uiBuffer, ostream* pOutput, FILE* pRun, timeIndex* pIndex);
+		void removeRuns();
+
+		string m_strTempDir;
+		u_int64_t m_uiMemoryBudget;
+
+		string m_strBuffer;						// rows as [2 x u_int32_t id][text without the interned fields], referenced by offset
+		stringTable m_table;
+		vector<sortRecord> m_vecRecords;
+		vector<sortRecord> m_vecScratch;
+		vector<string> m_vecRuns;
+		string m_strRow;
+		bool m_bFailed;
+};
+
+#endif /*MULTI2MACTIME_BODYSORTER_H_*/
@@ -0,0 +1,151 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "checkpoint.h"
+#include "processor.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+checkpoint::checkpoint(string strFilename, string strType, const vector<string>& vecFiles, u_int32_t uiInterval) : m_strFilename(strFilename), m_strType(strType),
+		m_uiOutput(0), m_uiInterval(uiInterval), m_uiRows(0) {
+	for (vector<string>::const_iterator it = vecFiles.begin(); it != vecFiles.end(); it++) {
+		fileState state = { *it, false, 0 };
+		m_vecFiles.push_back(state);
+	}
+	m_dLastSave = getClock();
+}
+
+// Reads the state saved by a previous run of the same command line
+bool checkpoint::load() {
+	ifstream fileCheckpoint(m_strFilename.c_str());
+	if (!fileCheckpoint) {
+		LOG_ERROR("checkpoint::load() Unable to open " << m_strFilename);
+		return false;
+	}
+
+	string strLine;
+	size_t uiFile = 0;
+	bool bHeader = false;
+	while (getline(fileCheckpoint, strLine)) {
+		size_t posTab = strLine.find('\t');
+		string strKey = strLine.substr(0, posTab);
+		string strValue = (posTab != string::npos ? strLine.substr(posTab + 1) : "");
+
+		if (strKey == "multi2mactime-checkpoint") {
+			if (strtoul(strValue.c_str(), NULL, 10) != CHECKPOINT_VERSION) {
+				LOG_ERROR("checkpoint::load() Unsupported checkpoint version (" << strValue << ") in " << m_strFilename);
+				return false;
+			}
+			bHeader = true;
+		} else if (strKey == "type") {
+			if (strValue != m_strType) {
+				LOG_ERROR("checkpoint::load() " << m_strFilename << " is for --type " << strValue << ", not " << m_strType);
+				return false;
+			}
+		} else if (strKey == "output") {
+			m_uiOutput = strtoull(strValue.c_str(), NULL, 10);
+		} else if (strKey == "file") {
+			size_t posName = strValue.find('\t');
+			if (posName == string::npos || uiFile >= m_vecFiles.size() || strValue.substr(posName + 1) != m_vecFiles[uiFile].strFilename) {
+				LOG_ERROR("checkpoint::load() The input files do not match those in " << m_strFilename);
+				return false;
+			}
+			string strState = strValue.substr(0, posName);
+			m_vecFiles[uiFile].bDone = (strState == "done");
+			m_vecFiles[uiFile].uiOffset = (m_vecFiles[uiFile].bDone ? 0 : strtoull(strState.c_str(), NULL, 10));
+			uiFile++;
+		}
+	}
+
+	if (!bHeader || uiFile != m_vecFiles.size()) {
+		LOG_ERROR("checkpoint::load() " << m_strFilename << " is not a complete checkpoint for these input files");
+		return false;
+	}
+	return true;
+}
+
+bool checkpoint::prepareOutput(bool bResume) const {
+	struct stat st;
+	if (fstat(STDOUT_FILENO, &st) != 0 || !S_ISREG(st.st_mode)) {
+		LOG_ERROR("checkpoint::prepareOutput() --checkpoint requires the output to be redirected to a file");
+		return false;
+	}
+	if (bResume) {
+		if ((u_int64_t)st.st_size < m_uiOutput) {
+			LOG_ERROR("checkpoint::prepareOutput() The output is smaller than at the checkpoint (" << st.st_size << " < " << m_uiOutput << " bytes); reopen it with >> to resume");
+			return false;
+		}
+		if (ftruncate(STDOUT_FILENO, m_uiOutput) != 0 || lseek(STDOUT_FILENO, m_uiOutput, SEEK_SET) < 0) {
+			LOG_ERROR("checkpoint::prepareOutput() Unable to truncate the output to " << m_uiOutput << " bytes");
+			return false;
+		}
+	}
+	return true;
+}
+
+bool checkpoint::isIntervalElapsed() const {
+	return (getClock() - m_dLastSave >= m_uiInterval);
+}
+
+bool checkpoint::save(size_t uiFile, u_int64_t uiOffset, bool bDone) {
+	m_vecFiles[uiFile].bDone = bDone;
+	m_vecFiles[uiFile].uiOffset = (bDone ? 0 : uiOffset);
+
+	// The output is written sequentially at its end, so its size is the position
+	struct stat st;
+	if (fflush(stdout) != 0 || fdatasync(STDOUT_FILENO) != 0 || fstat(STDOUT_FILENO, &st) != 0) {
+		LOG_ERROR("checkpoint::save() Unable to flush the output (" << strerror(errno) << ")");
+		return false;
+	}
+	m_uiOutput = st.st_size;
+
+	string strTemp = m_strFilename + ".tmp";
+	FILE* pFile = fopen(strTemp.c_str(), "w");
+	if (!pFile) {
+		LOG_ERROR("checkpoint::save() Unable to create " << strTemp);
+		return false;
+	}
+	fprintf(pFile, "multi2mactime-checkpoint\t%d\ntype\t%s\noutput\t%llu\n", CHECKPOINT_VERSION, m_strType.c_str(), (unsigned long long)m_uiOutput);
+	for (vector<fileState>::const_iterator it = m_vecFiles.begin(); it != m_vecFiles.end(); it++) {
+		if (it->bDone) {
+			fprintf(pFile, "file\tdone\t%s\n", it->strFilename.c_str());
+		} else {
+			fprintf(pFile, "file\t%llu\t%s\n", (unsigned long long)it->uiOffset, it->strFilename.c_str());
+		}
+	}
+	bool rv = (fflush(pFile) == 0 && fsync(fileno(pFile)) == 0);
+	rv = (fclose(pFile) == 0 && rv);
+	if (!rv || rename(strTemp.c_str(), m_strFilename.c_str()) != 0) {
+		LOG_ERROR("checkpoint::save() Unable to write " << m_strFilename);
+		return false;
+	}
+
+	m_dLastSave = getClock();
+	return true;
+}
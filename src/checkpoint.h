@@ -0,0 +1,84 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_CHECKPOINT_H_
+#define MULTI2MACTIME_CHECKPOINT_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// --checkpoint/--resume for long runs whose body output goes straight to a file on stdout. A checkpoint records, per
+// input file, whether it is done or the byte offset of the first line not yet output, and the size of the output at
+// that point. The output is flushed and synced before the checkpoint is written (to a temporary file, synced, then
+// renamed), so the output always holds at least everything the checkpoint claims.
+//
+// --resume truncates the output back to the recorded size, which drops any rows written after the checkpoint, skips
+// the files that are done and continues the partial one from its offset; the result is the same as an uninterrupted
+// run. The output must be reopened for appending (>>): a plain > empties it and is refused.
+//
+// Offsets are file positions, so inputs are read through mappedFile and must be regular files. A file is only recorded
+// as done once it has been read to its end; an input that cannot be opened stops the run, leaving the checkpoint at
+// the files before it.
+//
+// File format (version 1), tab separated:
+//
+//		multi2mactime-checkpoint	1
+//		type		<type>
+//		output	<bytes>
+//		file		done|<offset>	<filename>			(one per input, in command line order)
+
+#define CHECKPOINT_VERSION				1
+#define CHECKPOINT_DEFAULT_INTERVAL	60				// seconds
+#define CHECKPOINT_CHECK_ROWS			4096			// rows between clock reads
+
+class checkpoint {
+	public:
+		checkpoint(string strFilename, string strType, const vector<string>& vecFiles, u_int32_t uiInterval);
+
+		bool load();
+		// Checks that stdout is a regular file; when resuming, truncates it back to the checkpoint's output size
+		bool prepareOutput(bool bResume) const;
+
+		bool isFileDone(size_t uiFile) const { return m_vecFiles[uiFile].bDone; }
+		u_int64_t getFileOffset(size_t uiFile) const { return m_vecFiles[uiFile].uiOffset; }
+
+		bool isDue() {
+			return (++m_uiRows % CHECKPOINT_CHECK_ROWS == 0 && isIntervalElapsed());
+		}
+		// Flushes and syncs stdout, then records uiFile at uiOffset (or done) and the output size
+		bool save(size_t uiFile, u_int64_t uiOffset, bool bDone);
+
+	private:
+		checkpoint(const checkpoint&);
+		checkpoint& operator=(const checkpoint&);
+
+		bool isIntervalElapsed() const;
+
+		struct fileState {
+			string strFilename;
+			bool bDone;
+			u_int64_t uiOffset;
+		};
+
+		string m_strFilename;
+		string m_strType;
+		vector<fileState> m_vecFiles;
+		u_int64_t m_uiOutput;
+		u_int32_t m_uiInterval;
+		u_int64_t m_uiRows;
+		double m_dLastSave;
+};
+
+#endif /*MULTI2MACTIME_CHECKPOINT_H_*/
@@ -0,0 +1,172 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "columnWriter.h"
+#include "processor.h"
+#include "spanTracer.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+using namespace std;
+
+#define COLUMNWRITER_COLUMNS		(MULTI2MAC_BTIME + 1)
+#define COLUMNWRITER_IO_BUFFER	(1024 * 1024)
+
+static void appendU16(string* pstrData, u_int16_t uiValue) {
+	pstrData->push_back((char)(uiValue & 0xff));
+	pstrData->push_back((char)(uiValue >> 8));
+}
+
+static void appendU32(string* pstrData, u_int32_t uiValue) {
+	for (int i=0; i<32; i+=8) {
+		pstrData->push_back((char)((uiValue >> i) & 0xff));
+	}
+}
+
+static void appendU64(string* pstrData, u_int64_t uiValue) {
+	for (int i=0; i<64; i+=8) {
+		pstrData->push_back((char)((uiValue >> i) & 0xff));
+	}
+}
+
+static bool isTimeColumn(int iColumn) {
+	return (iColumn >= MULTI2MAC_ATIME && iColumn <= MULTI2MAC_BTIME);
+}
+
+columnWriter::columnWriter() : m_pFile(NULL), m_uiOffset(0), m_bFailed(false), m_uiRows(0),
+		m_vecDicts(COLUMNWRITER_COLUMNS), m_vecIDs(COLUMNWRITER_COLUMNS), m_timeMin(0), m_timeMax(0) {
+}
+
+columnWriter::~columnWriter() {
+	if (m_pFile) {
+		fclose(m_pFile);
+	}
+}
+
+bool columnWriter::open(string strFilename) {
+	m_strFilename = strFilename;
+	m_pFile = fopen(strFilename.c_str(), "wb");
+	if (!m_pFile) {
+		LOG_ERROR("columnWriter::open() Unable to create " << strFilename);
+		return false;
+	}
+	setvbuf(m_pFile, NULL, _IOFBF, COLUMNWRITER_IO_BUFFER);
+
+	string strHeader = "M2MCOL01";
+	appendU32(&strHeader, COLUMNWRITER_COLUMNS);
+	return write(strHeader);
+}
+
+bool columnWriter::write(const string& strData) {
+	if (!m_bFailed && fwrite(strData.data(), 1, strData.length(), m_pFile) != strData.length()) {
+		LOG_ERROR("columnWriter::write() Unable to write " << m_strFilename);
+		m_bFailed = true;
+	}
+	m_uiOffset += strData.length();
+	return !m_bFailed;
+}
+
+bool columnWriter::add(const string* strFields) {
+	if (m_bFailed || !m_pFile) {
+		return false;
+	}
+
+	for (int i=0; i<COLUMNWRITER_COLUMNS; i++) {
+		if (isTimeColumn(i)) {
+			int32_t timeVal = (strFields[i].length() ? strtol(strFields[i].c_str(), NULL, 10) : 0);
+			appendU32(&m_vecIDs[i], (u_int32_t)timeVal);
+			if (timeVal) {
+				if (!m_timeMin || timeVal < m_timeMin) {
+					m_timeMin = timeVal;
+				}
+				if (timeVal > m_timeMax) {
+					m_timeMax = timeVal;
+				}
+			}
+		} else {
+			// A block never has more than COLUMNWRITER_BLOCK_ROWS distinct values per column, so ids fit in 16 bits
+			appendU16(&m_vecIDs[i], (u_int16_t)m_vecDicts[i].intern(strFields[i]));
+		}
+	}
+
+	if (++m_uiRows == COLUMNWRITER_BLOCK_ROWS) {
+		return flushBlock();
+	}
+	return true;
+}
+
+bool columnWriter::flushBlock() {
+	if (!m_uiRows) {
+		return !m_bFailed;
+	}
+	traceSpan span("write column block");
+
+	blockInfo block = { m_uiOffset, m_uiRows, m_timeMin, m_timeMax };
+	m_vecBlocks.push_back(block);
+	DEBUG("columnWriter::flushBlock() " << m_uiRows << " rows at " << m_uiOffset << " (" << m_timeMin << "-" << m_timeMax << ")");
+
+	string strCount;
+	appendU32(&strCount, m_uiRows);
+	write(strCount);
+	for (int i=0; i<COLUMNWRITER_COLUMNS; i++) {
+		if (!isTimeColumn(i)) {
+			strCount.clear();
+			appendU32(&strCount, m_vecDicts[i].size());
+			write(strCount);
+			write(m_vecDicts[i].getEntries());
+			m_vecDicts[i].clear();
+		}
+		write(m_vecIDs[i]);
+		m_vecIDs[i].clear();
+	}
+
+	m_uiRows = 0;
+	m_timeMin = 0;
+	m_timeMax = 0;
+	return !m_bFailed;
+}
+
+bool columnWriter::close() {
+	if (!m_pFile) {
+		return false;
+	}
+	flushBlock();
+
+	u_int64_t uiFooter = m_uiOffset;
+	string strFooter;
+	appendU32(&strFooter, m_vecBlocks.size());
+	for (vector<blockInfo>::const_iterator it = m_vecBlocks.begin(); it != m_vecBlocks.end(); it++) {
+		appendU64(&strFooter, it->uiOffset);
+		appendU32(&strFooter, it->uiRows);
+		appendU32(&strFooter, (u_int32_t)it->timeMin);
+		appendU32(&strFooter, (u_int32_t)it->timeMax);
+	}
+	appendU64(&strFooter, uiFooter);
+	strFooter.append("M2MCOLFT");
+	write(strFooter);
+
+	if (fclose(m_pFile) != 0 && !m_bFailed) {
+		LOG_ERROR("columnWriter::close() Unable to write " << m_strFilename);
+		m_bFailed = true;
+	}
+	m_pFile = NULL;
+	return !m_bFailed;
+}
@@ -0,0 +1,81 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_COLUMNWRITER_H_
+#define MULTI2MACTIME_COLUMNWRITER_H_
+
+#include <string>
+#include <vector>
+#include <cstdio>
+using namespace std;
+
+#include "stringTable.h"
+
+// Binary columnar alternative to the text body file (--binary). Rows are buffered into blocks of up to
+// COLUMNWRITER_BLOCK_ROWS rows and written column by column, so a reader can load whole columns without tokenizing
+// text and can skip blocks that fall outside a time range using the footer.
+//
+// All integers are little-endian. The file is laid out as:
+//
+//	header	"M2MCOL01", u32 column count (11)
+//	block	u32 row count, then for each column in body file order (HASH ... BTIME):
+//				ATIME/MTIME/CTIME/BTIME	int32[rows] (empty or non-numeric values are stored as 0)
+//				all other columns			u32 dictionary size, dictionary entries as (u32 length, bytes), u16 id[rows]
+//	footer	u32 block count, then per block: u64 file offset, u32 row count, int32 min time, int32 max time
+//	trailer	u64 file offset of the footer, "M2MCOLFT"
+//
+// Dictionaries are per block, so every block can be decoded on its own and memory use stays bounded no matter how many
+// distinct values a column has. A block's min/max cover every non-zero time in any of its time columns (both are 0 if
+// the block has none).
+
+#define COLUMNWRITER_BLOCK_ROWS		65536
+
+class columnWriter {
+	public:
+		columnWriter();
+		~columnWriter();
+
+		bool open(string strFilename);
+		bool add(const string* strFields);
+		bool close();
+
+	private:
+		struct blockInfo {
+			u_int64_t uiOffset;
+			u_int32_t uiRows;
+			int32_t timeMin;
+			int32_t timeMax;
+		};
+
+		columnWriter(const columnWriter&);
+		columnWriter& operator=(const columnWriter&);
+
+		bool flushBlock();
+		bool write(const string& strData);
+
+		FILE* m_pFile;
+		string m_strFilename;
+		u_int64_t m_uiOffset;
+		bool m_bFailed;
+
+		u_int32_t m_uiRows;
+		vector<stringTable> m_vecDicts;								// per string column; ids are the dictionary indexes
+		vector<string> m_vecIDs;										// encoded ids/times, per column
+		int32_t m_timeMin;
+		int32_t m_timeMax;
+
+		vector<blockInfo> m_vecBlocks;
+};
+
+#endif /*MULTI2MACTIME_COLUMNWRITER_H_*/
@@ -0,0 +1,220 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "compressedOutput.h"
+#include "spanTracer.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+using namespace std;
+
+#define COMPRESSEDOUTPUT_GZIP_LEVEL		6
+#define COMPRESSEDOUTPUT_ZSTD_LEVEL		3
+
+compressedOutput::compressedOutput(int iCodec, unsigned int uiThreads, FILE* pOutput) : m_iCodec(iCodec), m_pOutput(pOutput), m_bFailed(false), m_bClosed(false), m_bStopping(false) {
+	if (uiThreads < 1) {
+		uiThreads = max(thread::hardware_concurrency(), 1u);
+	}
+	m_uiMaxPending = uiThreads * 2;
+	m_strBlock.reserve(COMPRESSEDOUTPUT_BLOCK);
+	for (unsigned int i=0; i<uiThreads; i++) {
+		m_vecWorkers.push_back(thread(&compressedOutput::workerLoop, this));
+	}
+}
+
+compressedOutput::~compressedOutput() {
+	close();
+}
+
+// Returns 0 for an unknown (or unavailable) codec name.
+int compressedOutput::getCodec(string strName) {
+	if (strName == "gzip" || strName == "gz") {
+		return COMPRESSEDOUTPUT_GZIP;
+#ifdef HAVE_ZSTD
+	} else if (strName == "zstd" || strName == "zst") {
+		return COMPRESSEDOUTPUT_ZSTD;
+#endif
+	}
+	return 0;
+}
+
+compressedOutput::int_type compressedOutput::overflow(int_type c) {
+	if (c != traits_type::eof()) {
+		char ch = traits_type::to_char_type(c);
+		xsputn(&ch, 1);
+	}
+	return (m_bFailed ? traits_type::eof() : traits_type::not_eof(c));
+}
+
+streamsize compressedOutput::xsputn(const char* pData, streamsize uiLength) {
+	streamsize uiDone = 0;
+	while (uiDone < uiLength) {
+		size_t uiCopy = min((size_t)(uiLength - uiDone), COMPRESSEDOUTPUT_BLOCK - m_strBlock.length());
+		m_strBlock.append(pData + uiDone, uiCopy);
+		uiDone += uiCopy;
+		if (m_strBlock.length() == COMPRESSEDOUTPUT_BLOCK) {
+			submitBlock();
+		}
+	}
+	return (m_bFailed ? 0 : uiLength);
+}
+
+// Blocks are only cut when full; a flush of cout must not produce a stream of tiny members.
+int compressedOutput::sync() {
+	return (m_bFailed ? -1 : 0);
+}
+
+void compressedOutput::submitBlock() {
+	if (m_strBlock.empty()) {
+		return;
+	}
+
+	compressJob* pJob = new compressJob();
+	pJob->strInput.swap(m_strBlock);
+	pJob->bDone = false;
+	pJob->bFailed = false;
+	m_strBlock.reserve(COMPRESSEDOUTPUT_BLOCK);
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_dequePending.push_back(pJob);
+		m_dequeQueued.push_back(pJob);
+	}
+	m_cvWork.notify_one();
+
+	writeCompleted(m_uiMaxPending);
+}
+
+// Writes finished blocks from the front of the queue, waiting while more than uiMaxPending are outstanding.
+void compressedOutput::writeCompleted(size_t uiMaxPending) {
+	unique_lock<mutex> lock(m_mutex);
+	while (!m_dequePending.empty()) {
+		compressJob* pJob = m_dequePending.front();
+		if (!pJob->bDone) {
+			if (m_dequePending.size() <= uiMaxPending) {
+				break;
+			}
+			traceSpan span("wait for compression");
+			m_cvDone.wait(lock);
+			continue;
+		}
+		m_dequePending.pop_front();
+		lock.unlock();
+
+		if (pJob->bFailed) {
+			if (!m_bFailed) {
+				LOG_ERROR("compressedOutput::writeCompleted() Unable to compress output block");
+			}
+			m_bFailed = true;
+		} else if (!m_bFailed) {
+			traceSpan span("write block");
+			if (fwrite(pJob->strOutput.data(), 1, pJob->strOutput.length(), m_pOutput) != pJob->strOutput.length()) {
+				LOG_ERROR("compressedOutput::writeCompleted() Unable to write compressed output");
+				m_bFailed = true;
+			}
+		}
+		delete pJob;
+
+		lock.lock();
+	}
+}
+
+void compressedOutput::workerLoop() {
+	traceSetThreadName("compress");
+	unique_lock<mutex> lock(m_mutex);
+	while (true) {
+		while (m_dequeQueued.empty() && !m_bStopping) {
+			m_cvWork.wait(lock);
+		}
+		if (m_dequeQueued.empty()) {
+			break;
+		}
+		compressJob* pJob = m_dequeQueued.front();
+		m_dequeQueued.pop_front();
+		lock.unlock();
+
+		bool bOK = false;
+		{
+			traceSpan span("compress block");
+			bOK = compressBlock(pJob);
+		}
+		string().swap(pJob->strInput);
+
+		lock.lock();
+		pJob->bFailed = !bOK;
+		pJob->bDone = true;
+		m_cvDone.notify_all();
+	}
+}
+
+bool compressedOutput::compressBlock(compressJob* pJob) {
+	if (m_iCodec == COMPRESSEDOUTPUT_GZIP) {
+		z_stream zs;
+		memset(&zs, 0, sizeof(zs));
+		if (deflateInit2(&zs, COMPRESSEDOUTPUT_GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {		// +16: gzip wrapper
+			return false;
+		}
+		pJob->strOutput.resize(deflateBound(&zs, pJob->strInput.length()));
+		zs.next_in = (Bytef*)pJob->strInput.data();
+		zs.avail_in = pJob->strInput.length();
+		zs.next_out = (Bytef*)&pJob->strOutput[0];
+		zs.avail_out = pJob->strOutput.length();
+		int iResult = deflate(&zs, Z_FINISH);
+		pJob->strOutput.resize(zs.total_out);
+		deflateEnd(&zs);
+		return (iResult == Z_STREAM_END);
+#ifdef HAVE_ZSTD
+	} else if (m_iCodec == COMPRESSEDOUTPUT_ZSTD) {
+		pJob->strOutput.resize(ZSTD_compressBound(pJob->strInput.length()));
+		size_t uiResult = ZSTD_compress(&pJob->strOutput[0], pJob->strOutput.length(), pJob->strInput.data(), pJob->strInput.length(), COMPRESSEDOUTPUT_ZSTD_LEVEL);
+		if (ZSTD_isError(uiResult)) {
+			return false;
+		}
+		pJob->strOutput.resize(uiResult);
+		return true;
+#endif
+	}
+	return false;
+}
+
+bool compressedOutput::close() {
+	if (!m_bClosed) {
+		m_bClosed = true;
+		submitBlock();
+		writeCompleted(0);
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_bStopping = true;
+		}
+		m_cvWork.notify_all();
+		for (vector<thread>::iterator it = m_vecWorkers.begin(); it != m_vecWorkers.end(); it++) {
+			it->join();
+		}
+		if (fflush(m_pOutput) != 0 && !m_bFailed) {
+			LOG_ERROR("compressedOutput::close() Unable to write compressed output");
+			m_bFailed = true;
+		}
+	}
+	return !m_bFailed;
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_COMPRESSEDOUTPUT_H_
+#define MULTI2MACTIME_COMPRESSEDOUTPUT_H_
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <streambuf>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// Compressing stream buffer for the body output (--compress). Installed as cout's buffer, it cuts the output into
+// COMPRESSEDOUTPUT_BLOCK sized blocks and compresses each one independently on a pool of worker threads, so parsing is
+// not limited by the speed of a single compressor. Blocks are written in order as complete gzip members or zstd
+// frames; a concatenation of either is itself a valid .gz/.zst file that the standard tools decompress as one stream.
+//
+// The pool defaults to one thread per hardware thread. At most two blocks per thread are held in memory; the writing
+// thread waits for the oldest block when that limit is reached.
+
+#define COMPRESSEDOUTPUT_GZIP		1
+#define COMPRESSEDOUTPUT_ZSTD		2
+
+#define COMPRESSEDOUTPUT_BLOCK	(4 * 1024 * 1024)
+
+class compressedOutput : public streambuf {
+	public:
+		compressedOutput(int iCodec, unsigned int uiThreads, FILE* pOutput);
+		~compressedOutput();
+
+		bool close();
+
+		static int getCodec(string strName);
+
+	protected:
+		int_type overflow(int_type c);
+		streamsize xsputn(const char* pData, streamsize uiLength);
+		int sync();
+
+	private:
+		struct compressJob {
+			string strInput;
+			string strOutput;
+			bool bDone;
+			bool bFailed;
+		};
+
+		compressedOutput(const compressedOutput&);
+		compressedOutput& operator=(const compressedOutput&);
+
+		void submitBlock();
+		void writeCompleted(size_t uiMaxPending);
+		void workerLoop();
+		bool compressBlock(compressJob* pJob);
+
+		int m_iCodec;
+		FILE* m_pOutput;
+		size_t m_uiMaxPending;
+		bool m_bFailed;
+		bool m_bClosed;
+		string m_strBlock;
+
+		mutex m_mutex;
+		condition_variable m_cvWork;					// workers wait for queued jobs
+		condition_variable m_cvDone;					// the writer waits for the oldest job
+		deque<compressJob*> m_dequePending;			// in output order
+		deque<compressJob*> m_dequeQueued;			// not yet picked up by a worker
+		bool m_bStopping;
+		vector<thread> m_vecWorkers;
+};
+
+#endif /*MULTI2MACTIME_COMPRESSEDOUTPUT_H_*/
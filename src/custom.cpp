@@ -17,6 +17,9 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
+#include "textSearch.h"
 
 #include <string>
 using namespace std;
@@ -65,17 +68,23 @@ void processCustomVPN_S1(string* pstrData, u_int32_t uiSkew, bool bNormalize, ti
 					(0 <= uiHour && uiHour <= 23) &&
 					(0 <= uiMin && uiMin <= 60) &&
 					(0 <= uiSec && uiSec <= 60)) {
+					  traceStage stage(SPANTRACER_STAGE_TIME);
 					  boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
 					  if (pTZCalc->createLocalTime(uiMonth, uiDay, uiYear, uiHour, uiMin, uiSec, &ldt)) {
 							timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 					  } else {
-							ERROR("processCustomVPN_S1() Unable to createLocalTime()");
+							countTimeFailure();
+							ROW_ERROR("processCustomVPN_S1() Unable to createLocalTime()", "");
 					  }
 			} else {
 					  DEBUG("whoops");
+					  countTimeFailure();
 				//ERROR
 			} //if (	(1 <= uiMonth && uiMonth <= 12) &&
 		}
+		if (!inTimeWindow(timeVal)) {
+			return;
+		}
 	
 		//Output Values
 		strFields[MULTI2MAC_DETAIL]	= delimText.getField(2);	//username
@@ -116,6 +125,7 @@ void processCustomFSEM(string* pstrData, u_int32_t uiSkew, bool bNormalize, time
 				uiHour = 0;
 			}
 		}
+		traceStage stage(SPANTRACER_STAGE_TIME);
 		boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
 		if (pTZCalc->createLocalTime(	boost_lexical_cast_wrapper<u_int16_t>(delimDate.getField(0)),	//month
 							 				boost_lexical_cast_wrapper<u_int16_t>(delimDate.getField(1)),	//day
@@ -126,13 +136,17 @@ void processCustomFSEM(string* pstrData, u_int32_t uiSkew, bool bNormalize, time
 											&ldt)) {	//second
 			timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 		} else {
-			ERROR("processCustomFSEM() Unable to createLocalTime()");
+			countTimeFailure();
+			ROW_ERROR("processCustomFSEM() Unable to createLocalTime()", "");
 		}
 	}
+	if (!inTimeWindow(timeVal)) {
+		return;
+	}
 
 	string strIPPort = delimText.getField(1);
-	string strIP = findSubString(strIPPort, 0, "", " ");
-	string strPort = findSubString(strIPPort, 0, " :", "");
+	string strIP = getSpanString(&strIPPort, findTextSpan(&strIPPort, 0, "", " "));
+	string strPort = getSpanString(&strIPPort, findTextSpan(&strIPPort, 0, " :", ""));
 
 	//Output Values
 	strFields[MULTI2MAC_DETAIL]		= delimText.getField(2);
@@ -173,6 +187,7 @@ void processCustomFSBT(string* pstrData, u_int32_t uiSkew, bool bNormalize, time
 				uiHour = 0;
 			}
 		}
+		traceStage stage(SPANTRACER_STAGE_TIME);
 		boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
 		if (pTZCalc->createLocalTime(	boost_lexical_cast_wrapper<u_int16_t>(delimDate.getField(0)),	//month
 							 															boost_lexical_cast_wrapper<u_int16_t>(delimDate.getField(1)),	//day
@@ -183,13 +198,17 @@ void processCustomFSBT(string* pstrData, u_int32_t uiSkew, bool bNormalize, time
 																						&ldt)) {	//second
 			timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 		} else {
-			ERROR("processCustomFSBT() Unable to createLocalTime()");
+			countTimeFailure();
+			ROW_ERROR("processCustomFSBT() Unable to createLocalTime()", "");
 		}
 	}
+	if (!inTimeWindow(timeVal)) {
+		return;
+	}
 
 	string strIPPort = delimText.getField(1);
-	string strIP = findSubString(strIPPort, 0, "", " ");
-	string strPort = findSubString(strIPPort, 0, " :", "");
+	string strIP = getSpanString(&strIPPort, findTextSpan(&strIPPort, 0, "", " "));
+	string strPort = getSpanString(&strIPPort, findTextSpan(&strIPPort, 0, " :", ""));
 
 	//Output Values
 	strFields[MULTI2MAC_DETAIL]		= delimText.getField(2);
@@ -17,8 +17,13 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "keyScanner.h"
+#include "textSearch.h"
+#include "syslog.h"
 
 #include <string>
+#include <cstdlib>
+#include <cstring>
 using namespace std;
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
@@ -27,19 +32,56 @@ using namespace std;
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
+#define FORTIGATE_KEY_TIME		0
+#define FORTIGATE_KEY_SRCIP		1
+#define FORTIGATE_KEY_SRCPORT		2
+#define FORTIGATE_KEY_DSTIP		3
+#define FORTIGATE_KEY_DSTPORT		4
+#define FORTIGATE_KEY_URL			5
+#define FORTIGATE_KEY_SERVICE		6
+#define FORTIGATE_KEY_SENT			7
+#define FORTIGATE_KEY_RCVD			8
+#define FORTIGATE_KEY_COUNT		9
+
+static const keyDefinition FORTIGATE_KEYS[FORTIGATE_KEY_COUNT] = {
+	{"itime=",			"\""},
+	{"srcip=",			"\""},
+	{"srcport=",		"\""},
+	{"dstip=",			"\""},
+	{"dstport=",		"\""},
+	{"referralurl=",	","},
+	{"service=",		"\""},
+	{"sentbyte=",		"\""},
+	{"rcvdbyte=",		"\""},
+};
+static const keyScanner fortigateKeys(FORTIGATE_KEYS, FORTIGATE_KEY_COUNT);
+
+int32_t getFortiGate1K5Time(const string* pstrData, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
+	// itime is a Unix time; output as-is (no skew) by processFortiGate1K5()
+	textSpan span = findTextSpan(pstrData, 0, FORTIGATE_KEYS[FORTIGATE_KEY_TIME].cstrKey, FORTIGATE_KEYS[FORTIGATE_KEY_TIME].cstrDelim);
+	return (span.len ? strtol(pstrData->c_str() + span.pos, NULL, 10) : -1);
+}
+
 void processFortiGate1K5(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
 	DEBUG("processFortiGate1K5()");
 	// "itime=1503697041","date=2017-08-25","time=15:37:21","devid=FG1K5D3I16804933","vd=root","type=""utm""","subtype=""webfilter""","action=""passthrough""","","","","","","","","","cat=52","catdesc=""Information Technology""","","","","","","","","","devname=FG1Kcopper","direction=""outgoing""","","dstintf=""port26""","dstintfrole=""undefined""","dstip=54.243.44.67","dstport=80","dtime=1503675441","","eventtype=""ftgd_allow""","","","hostname=""edge.simplereach.com""","","","","level=""notice""","logid=""0317013312""","logtime=1503697041","logver=56","method=""domain""","msg=""URL belongs to an allowed category in policy""","policyid=1","","","profile=""NTC_Web_CTA""","proto=6","rcvdbyte=0","","","referralurl=""http://www.cracked.com/pictofacts-766-28-things-you-completely-misunderstood-as-child-part-2/""","reqtype=""referral""","","sentbyte=1014","","service=""HTTP""","sessionid=18827768","","","srcintf=""port17""","srcintfrole=""undefined""","srcip=172.31.246.13","srcport=63661","","","","","","","url=""/t?pid=4f6a4e1ea782f30c41000002&title=28%20Things%20You%20Completely%20Misunderstood%20As%20A%20Child%2C%20Part%202&url=http://www.cracked.com/pictofacts-766-28-things-you-completely-misunderstood-as-child-part-2/&page_url=http://www.cracked.com/pictofacts-766-2
 	
-	string strTime =		findSubString(*pstrData, 0, "itime=", "\"");
-	string strSrc = 		findSubString(*pstrData, 0, "srcip=", "\"") + ":" + 
-			  					findSubString(*pstrData, 0, "srcport=", "\"");
-	string strDst = 		findSubString(*pstrData, 0, "dstip=", "\"") + ":" + 
-			  					findSubString(*pstrData, 0, "dstport=", "\"");
-	string strURL = 		findSubString(*pstrData, 0, "referralurl=", ",");
-	string strService =	findSubString(*pstrData, 0, "service=", "\"");		  					
-	string strBytes = 	findSubString(*pstrData, 0, "sentbyte=", "\"") + "/" +
-								findSubString(*pstrData, 0, "rcvdbyte=", "\"");
+	textSpan spans[FORTIGATE_KEY_COUNT];
+	fortigateKeys.scan(pstrData, 0, spans);
+
+	string strTime =		getSpanString(pstrData, spans[FORTIGATE_KEY_TIME]);
+	if (!inTimeWindow(strtol(strTime.c_str(), NULL, 10))) {
+		return;
+	}
+
+	string strSrc = 		getSpanString(pstrData, spans[FORTIGATE_KEY_SRCIP]) + ":" + 
+			  					getSpanString(pstrData, spans[FORTIGATE_KEY_SRCPORT]);
+	string strDst = 		getSpanString(pstrData, spans[FORTIGATE_KEY_DSTIP]) + ":" + 
+			  					getSpanString(pstrData, spans[FORTIGATE_KEY_DSTPORT]);
+	string strURL = 		getSpanString(pstrData, spans[FORTIGATE_KEY_URL]);
+	string strService =	getSpanString(pstrData, spans[FORTIGATE_KEY_SERVICE]);
+	string strBytes = 	getSpanString(pstrData, spans[FORTIGATE_KEY_SENT]) + "/" +
+								getSpanString(pstrData, spans[FORTIGATE_KEY_RCVD]);
 
 	//Output Values
 	strFields[MULTI2MAC_DETAIL]	= strURL;
@@ -54,3 +96,115 @@ void processFortiGate1K5(string* pstrData, u_int32_t uiSkew, bool bNormalize, ti
 	//strFields[MULTI2MAC_BTIME]	= 
 }
 
+#define FORTIGATE_SYSLOG_DATE			0
+#define FORTIGATE_SYSLOG_TIME			1
+#define FORTIGATE_SYSLOG_EVENTTIME		2
+#define FORTIGATE_SYSLOG_SRCIP			3
+#define FORTIGATE_SYSLOG_SRCPORT		4
+#define FORTIGATE_SYSLOG_DSTIP			5
+#define FORTIGATE_SYSLOG_DSTPORT		6
+#define FORTIGATE_SYSLOG_HOSTNAME		7
+#define FORTIGATE_SYSLOG_URL			8
+#define FORTIGATE_SYSLOG_MSG			9
+#define FORTIGATE_SYSLOG_ACTION		10
+#define FORTIGATE_SYSLOG_SERVICE		11
+#define FORTIGATE_SYSLOG_COUNT			12
+
+static const char* FORTIGATE_SYSLOG_KEYS[FORTIGATE_SYSLOG_COUNT] = {
+	"date", "time", "eventtime", "srcip", "srcport", "dstip", "dstport", "hostname", "url", "msg", "action", "service"
+};
+
+// Walks the space separated key=value pairs of a native FortiGate syslog line; values are either bare or quoted (and
+// may then contain spaces). Tokens without an '=' (the syslog header) are skipped, and keys must match exactly, so
+// e.g. "tranip=" is never taken for "srcip=". The first occurrence of each key wins.
+static void scanFortiGateSyslog(const string* pstrData, size_t pos, textSpan* spans) {
+	const char* pData = pstrData->data();
+	size_t len = pstrData->length();
+	for (int i=0; i<FORTIGATE_SYSLOG_COUNT; i++) {
+		spans[i].pos = spans[i].len = 0;
+	}
+
+	while (pos < len) {
+		while (pos < len && pData[pos] == ' ') {
+			pos++;
+		}
+		size_t posKey = pos;
+		while (pos < len && pData[pos] != '=' && pData[pos] != ' ') {
+			pos++;
+		}
+		if (pos >= len || pData[pos] != '=') {
+			continue;
+		}
+		size_t lenKey = pos - posKey;
+
+		textSpan value;
+		pos++;
+		if (pos < len && pData[pos] == '"') {
+			size_t posEnd = pstrData->find('"', pos + 1);
+			posEnd = (posEnd != string::npos ? posEnd : len);
+			value.pos = pos + 1;
+			value.len = posEnd - pos - 1;
+			pos = posEnd + 1;
+		} else {
+			size_t posEnd = pstrData->find(' ', pos);
+			posEnd = (posEnd != string::npos ? posEnd : len);
+			value.pos = pos;
+			value.len = posEnd - pos;
+			pos = posEnd;
+		}
+
+		for (int i=0; i<FORTIGATE_SYSLOG_COUNT; i++) {
+			if (strlen(FORTIGATE_SYSLOG_KEYS[i]) == lenKey && memcmp(pData + posKey, FORTIGATE_SYSLOG_KEYS[i], lenKey) == 0) {
+				if (!spans[i].len) {
+					spans[i] = value;
+				}
+				break;
+			}
+		}
+	}
+}
+
+void processFortiGateSyslog(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader) {
+	DEBUG("processFortiGateSyslog()");
+	// <189>Aug 25 15:37:21 10.1.1.1 date=2017-08-25 time=15:37:21 devname="FG1Kcopper" devid="FG1K5D3I16804933" logid="0317013312" type="utm" subtype="webfilter" eventtype="ftgd_allow" level="notice" vd="root" policyid=1 sessionid=18827768 srcip=172.31.246.13 srcport=63661 srcintf="port17" dstip=54.243.44.67 dstport=80 dstintf="port26" proto=6 service="HTTP" hostname="edge.simplereach.com" action="passthrough" reqtype="referral" url="/t?pid=4f6a4e1ea782f30c41000002" sentbyte=1014 rcvdbyte=0 direction="outgoing" msg="URL belongs to an allowed category in policy" cat=52 catdesc="Information Technology"
+
+	textSpan spans[FORTIGATE_SYSLOG_COUNT];
+	scanFortiGateSyslog(pstrData, (pHeader ? pHeader->posBody : 0), spans);
+
+	// The device's own date/time (local to the device, like the other syslog parsers); FortiOS versions that log only
+	// eventtime give it in seconds or, with more than 10 digits, in finer units
+	int32_t timeVal = -1;
+	if (spans[FORTIGATE_SYSLOG_DATE].len && spans[FORTIGATE_SYSLOG_TIME].len) {
+		timeVal = getUnix32FromLayout(getSpanString(pstrData, spans[FORTIGATE_SYSLOG_DATE]) + " " + getSpanString(pstrData, spans[FORTIGATE_SYSLOG_TIME]), "%Y-%m-%d %H:%M:%S", uiSkew, pTZCalc);
+	} else if (spans[FORTIGATE_SYSLOG_EVENTTIME].len) {
+		string strEventTime = getSpanString(pstrData, spans[FORTIGATE_SYSLOG_EVENTTIME]).substr(0, 10);
+		timeVal = strtol(strEventTime.c_str(), NULL, 10);
+		if (timeVal > 0) {
+			timeVal += uiSkew;
+		} else {
+			countTimeFailure();
+			timeVal = -1;
+		}
+	}
+	if (!inTimeWindow(timeVal)) {
+		return;
+	}
+
+	// Web filter events carry the URL; traffic and event logs fall back to their message or action
+	string strDetail = 	getSpanString(pstrData, spans[FORTIGATE_SYSLOG_HOSTNAME]) + getSpanString(pstrData, spans[FORTIGATE_SYSLOG_URL]);
+	if (strDetail.length() == 0) {
+		strDetail = getSpanString(pstrData, (spans[FORTIGATE_SYSLOG_MSG].len ? spans[FORTIGATE_SYSLOG_MSG] : spans[FORTIGATE_SYSLOG_ACTION]));
+	}
+	string strSrc = 		getSpanString(pstrData, spans[FORTIGATE_SYSLOG_SRCIP]) + ":" +
+			  					getSpanString(pstrData, spans[FORTIGATE_SYSLOG_SRCPORT]);
+	string strDst = 		getSpanString(pstrData, spans[FORTIGATE_SYSLOG_DSTIP]) + ":" +
+			  					getSpanString(pstrData, spans[FORTIGATE_SYSLOG_DSTPORT]);
+
+	//Output Values; the same columns as the CSV export above
+	strFields[MULTI2MAC_DETAIL]	= strDetail;
+	strFields[MULTI2MAC_TYPE]		= getSpanString(pstrData, spans[FORTIGATE_SYSLOG_SERVICE]);
+	strFields[MULTI2MAC_LOG]		= "----fortg1k5";
+	strFields[MULTI2MAC_FROM]		= strSrc;
+	strFields[MULTI2MAC_TO]			= strDst;
+	strFields[MULTI2MAC_ATIME]		= (timeVal > 0 ? boost_lexical_cast_wrapper<string>(timeVal) : "");
+}
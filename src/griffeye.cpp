@@ -17,6 +17,7 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
 
 #include <string>
 using namespace std;
@@ -56,7 +57,7 @@ void processGriffeyeCSV(string* pstrData, string* pstrHeader, u_int32_t uiSkew,
 			strPath					  	  = stripQualifiers(delimText.getValue(delimHeader.getColumnByValue("File Path")), '"');
 		}
 		if (strPath.length() == 0) {
-			WARNING("processGriffeyeCSV() No valid file/directory path located");
+			ROW_WARNING("processGriffeyeCSV() No valid file/directory path located", "");
 		}
 
 		strFields[MULTI2MAC_DETAIL]	= strPath + "\\" + stripQualifiers(delimText.getValue(delimHeader.getColumnByValue("File Name")), '"');
@@ -70,7 +71,7 @@ void processGriffeyeCSV(string* pstrData, string* pstrHeader, u_int32_t uiSkew,
 		strFields[MULTI2MAC_CTIME]		= (cTimeVal > 0 ? boost_lexical_cast_wrapper<string>(cTimeVal) : "");
 		strFields[MULTI2MAC_BTIME]		= (bTimeVal > 0 ? boost_lexical_cast_wrapper<string>(bTimeVal) : "");
 	} else {
-		WARNING("processGriffeyeCSV() No valid time values found (" << *pstrData << ")");
+		ROW_WARNING("processGriffeyeCSV() No valid time values found", " (" << *pstrData << ")");
 	}
 }
 
@@ -17,6 +17,9 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
+#include "textSearch.h"
 
 #include <string>
 using namespace std;
@@ -55,8 +58,10 @@ void processHirsch(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZone
 	
 	delimTextRow delimText(*pstrData, ',');
 	string strDateTime = delimText.getField(14);
-	string strDate = findSubString(strDateTime, 0, "", " ");
-	string strTime = findSubString(findSubString(findSubString(strDateTime, 0, " ", ""), 0, " ", ""), 0, " ", ""); //time may have up to three leading spaces; dirty way to get rid of them...
+	textSpan spanDate = findTextSpan(&strDateTime, 0, "", " ");
+	string strDate = getSpanString(&strDateTime, spanDate);
+	size_t posTime = strDateTime.find_first_not_of(' ', spanDate.pos + spanDate.len); //time may have several leading spaces
+	string strTime = (posTime != string::npos ? strDateTime.substr(posTime) : "");
 
 	delimTextRow delimDate(strDate, '/');
 	delimTextRow delimTime(strTime, ':');
@@ -87,14 +92,17 @@ void processHirsch(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZone
 					(0 <= uiHour && uiHour <= 23) &&
 					(0 <= uiMin && uiMin <= 60) &&
 					(0 <= uiSec && uiSec <= 60)) {
+					  traceStage stage(SPANTRACER_STAGE_TIME);
 					  boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
 					  if (pTZCalc->createLocalTime(uiMonth, uiDay, uiYear, uiHour, uiMin, uiSec, &ldt)) {
 							timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 					  } else {
-						  ERROR("processHirsch() Unable to createLocalTime()");
+						  countTimeFailure();
+						  ROW_ERROR("processHirsch() Unable to createLocalTime()", "");
 					  }
 			} else {
 					  DEBUG("whoops");
+					  countTimeFailure();
 				//ERROR
 			} //if (	(1 <= uiMonth && uiMonth <= 12) &&
 		}
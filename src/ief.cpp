@@ -17,6 +17,7 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
 #include "iefTypes.h"
 
 #include <string>
@@ -56,7 +57,7 @@ void processIEF(string* pstrData, string* pstrHeader, string* pstrFilename, u_in
 		getIEFFields(&delimText, &delimHeader, idArtifact + IEF_PRIMARY, uiSkew, pTZCalc, strFields);
 		getIEFFields(&delimText, &delimHeader, idArtifact + IEF_SECONDARY, uiSkew, pTZCalc, strSecondary);
 	} else {
-		ERROR(*pstrFilename << ": processIEF() Unknown artifact (" << *pstrFilename << ")");
+		ROW_ERROR("processIEF() Unknown artifact", " (" << *pstrFilename << ")");
 	}
 }
 
@@ -70,7 +71,7 @@ int32_t getIEFTime(string strTime, u_int32_t idArtifact, u_int32_t uiSkew, timeZ
 			dtmTime = getUnix32DateTimeFromString(strTime, ' ', '/', ':', uiSkew, pTZCalc);
 		}
 		if (dtmTime <= 0) {
-			ERROR("getIEFTime() Failed to convert non-empty string to time value (" << strTime << ")");
+			ROW_ERROR("getIEFTime() Failed to convert non-empty string to time value", " (" << strTime << ")");
 		}
 	}
 
@@ -128,7 +129,7 @@ bool getIEFFields(delimTextRow* p_delimText, delimTextRow* p_delimHeader, u_int3
 	
 		rv = true;
 	} else {
-		ERROR("getIEFFields(): Invalid pointer");
+		LOG_ERROR("getIEFFields(): Invalid pointer");
 	}
 
 	DEBUG("getIEFFields(): Exit");
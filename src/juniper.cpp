@@ -17,6 +17,11 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
+#include "textSearch.h"
+#include "syslog.h"
+#include "keyScanner.h"
 
 #include <string>
 using namespace std;
@@ -27,35 +32,83 @@ using namespace std;
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
-void processJuniper(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
+#define JUNIPER_KEY_TIME		0
+#define JUNIPER_KEY_SRC			1
+#define JUNIPER_KEY_FROM		2
+#define JUNIPER_KEY_DST			3
+#define JUNIPER_KEY_TO			4
+#define JUNIPER_KEY_SERVICE	5
+#define JUNIPER_KEY_SENT		6
+#define JUNIPER_KEY_RCVD		7
+#define JUNIPER_KEY_COUNT		8
+
+static const keyDefinition JUNIPER_KEYS[JUNIPER_KEY_COUNT] = {
+	{"start_time=\"",	"\" "},
+	{"src=",				" "},
+	{" from ",			"/"},
+	{"dst=",				" "},
+	{" to ",				"/"},
+	{"service=",		" "},
+	{"sent=",			" "},
+	{"rcvd=",			" "},
+};
+static const keyScanner juniperKeys(JUNIPER_KEYS, JUNIPER_KEY_COUNT);
+
+static int32_t getJuniperStartTime(const string& strTime, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
 	int32_t timeVal = -1; 
-	string strTime = findSubString(*pstrData, 34, "start_time=\"", "\" ");
 	if (strTime.length()) {
+			  traceStage stage(SPANTRACER_STAGE_TIME);
 			  boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
 			  if (pTZCalc->createLocalTime(strTime, "%Y-%m-%d %H:%M:%S", &ldt)) {
 					timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 			  } else {
-					ERROR("processJuniper() Unable to createLocalTime()");
+					countTimeFailure();
+					ROW_ERROR("processJuniper() Unable to createLocalTime()", "");
 			  }
 	}
-	string strMsg = findSubString(*pstrData, 34, "[", "");
-	string strMsgType = findSubString(strMsg, 34, "]", ": ");
-	strMsg = findSubString(strMsg, 0, ": ", "");
+	return timeVal;
+}
+
+void processJuniper(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader) {
+	// Mar 20 12:00:00 10.0.0.1 ns5gt: NetScreen device_id=ns5gt  [Root]system-notification-00257(traffic): start_time="2019-03-20 12:00:00" ... src=10.0.0.2 dst=10.1.1.1 ...
+	syslogHeader header;
+	if (pHeader != NULL) {
+		header = *pHeader;
+	} else {
+		decodeSyslogHeader(pstrData, &header);
+	}
+	size_t posBody = header.posBody;
+
+	textSpan spans[JUNIPER_KEY_COUNT];
+	juniperKeys.scan(pstrData, posBody, spans);
+
+	int32_t timeVal = getJuniperStartTime(getSpanString(pstrData, spans[JUNIPER_KEY_TIME]), uiSkew, pTZCalc);
+	if (!inTimeWindow(timeVal)) {
+		return;
+	}
+
+	string strMsg;
+	string strMsgType;
+	textSpan spanMsg = findTextSpan(pstrData, posBody, "[", "");
+	if (spanMsg.len) {
+		strMsgType = getSpanString(pstrData, findTextSpan(pstrData, spanMsg.pos, "]", ": "));
+		strMsg = getSpanString(pstrData, findTextSpan(pstrData, spanMsg.pos, ": ", ""));
+	}
 	
-	string strSrc = findSubString(*pstrData, 34, "src=", " ");
+	string strSrc = getSpanString(pstrData, spans[JUNIPER_KEY_SRC]);
 	if (!strSrc.length()) {
-		strSrc = findSubString(*pstrData, 34, " from ", "/");
+		strSrc = getSpanString(pstrData, spans[JUNIPER_KEY_FROM]);
 	}
-	string strDst = findSubString(*pstrData, 34, "dst=", " ");
+	string strDst = getSpanString(pstrData, spans[JUNIPER_KEY_DST]);
 	if (!strDst.length()) {
-		strDst = findSubString(*pstrData, 34, " to ", "/");
+		strDst = getSpanString(pstrData, spans[JUNIPER_KEY_TO]);
 	}
 	
-	string strService = findSubString(*pstrData, 34, "service=", " ");
+	string strService = getSpanString(pstrData, spans[JUNIPER_KEY_SERVICE]);
 	
 	string strBytes;
-	string strSent = findSubString(*pstrData, 34, "sent=", " ");
-	string strRcvd = findSubString(*pstrData, 34, "rcvd=", " ");
+	string strSent = getSpanString(pstrData, spans[JUNIPER_KEY_SENT]);
+	string strRcvd = getSpanString(pstrData, spans[JUNIPER_KEY_RCVD]);
 	if (strSent.length() || strRcvd.length()) {
 			strBytes = strSent + "/" + strRcvd;
 	}
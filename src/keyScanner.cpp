@@ -0,0 +1,122 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "keyScanner.h"
+#include "textSearch.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstring>
+using namespace std;
+
+keyScanner::keyScanner(const keyDefinition* pKeys, size_t count) : m_vecKeys(pKeys, pKeys + count), m_uiClassCount(1) {
+	compile();
+}
+
+void keyScanner::compile() {
+	// Only bytes that appear in some key need their own transition column; everything else shares class 0.
+	memset(m_classes, 0, sizeof(m_classes));
+	for (vector<keyDefinition>::const_iterator it = m_vecKeys.begin(); it != m_vecKeys.end(); it++) {
+		for (const unsigned char* p = (const unsigned char*)it->cstrKey; *p; p++) {
+			if (!m_classes[*p]) {
+				m_classes[*p] = m_uiClassCount++;
+			}
+		}
+	}
+
+	// Build the trie (-1 marks a missing edge)
+	m_vecDelta.assign(m_uiClassCount, -1);
+	m_vecOutputs.assign(1, vector<int>());
+	for (size_t i=0; i<m_vecKeys.size(); i++) {
+		int32_t state = 0;
+		for (const unsigned char* p = (const unsigned char*)m_vecKeys[i].cstrKey; *p; p++) {
+			int32_t* pNext = &m_vecDelta[state * m_uiClassCount + m_classes[*p]];
+			if (*pNext < 0) {
+				*pNext = m_vecOutputs.size();
+				m_vecOutputs.push_back(vector<int>());
+				m_vecDelta.resize(m_vecDelta.size() + m_uiClassCount, -1);
+				pNext = &m_vecDelta[state * m_uiClassCount + m_classes[*p]];
+			}
+			state = *pNext;
+		}
+		m_vecOutputs[state].push_back(i);
+	}
+
+	// Breadth-first pass converts the trie into a full DFA: missing edges follow the failure link and each state
+	// inherits the outputs of its failure state.
+	vector<int32_t> vecFail(m_vecOutputs.size(), 0);
+	deque<int32_t> queue;
+	for (size_t c=0; c<m_uiClassCount; c++) {
+		int32_t& next = m_vecDelta[c];
+		if (next < 0) {
+			next = 0;
+		} else {
+			queue.push_back(next);
+		}
+	}
+	while (!queue.empty()) {
+		int32_t state = queue.front();
+		queue.pop_front();
+		for (size_t c=0; c<m_uiClassCount; c++) {
+			int32_t& next = m_vecDelta[state * m_uiClassCount + c];
+			int32_t fallback = m_vecDelta[vecFail[state] * m_uiClassCount + c];
+			if (next < 0) {
+				next = fallback;
+			} else {
+				vecFail[next] = fallback;
+				m_vecOutputs[next].insert(m_vecOutputs[next].end(), m_vecOutputs[fallback].begin(), m_vecOutputs[fallback].end());
+				queue.push_back(next);
+			}
+		}
+	}
+
+	DEBUG("keyScanner::compile() " << m_vecKeys.size() << " keys, " << m_vecOutputs.size() << " states, " << m_uiClassCount << " classes");
+}
+
+void keyScanner::scan(const string* pstrData, size_t pos, textSpan* spans) const {
+	size_t uiRemaining = m_vecKeys.size();
+	for (size_t i=0; i<uiRemaining; i++) {
+		spans[i].pos = string::npos;
+		spans[i].len = 0;
+	}
+
+	const unsigned char* pData = (const unsigned char*)pstrData->data();
+	size_t len = pstrData->length();
+	int32_t state = 0;
+	for (; pos < len && uiRemaining; pos++) {
+		state = m_vecDelta[state * m_uiClassCount + m_classes[pData[pos]]];
+		const vector<int>& outputs = m_vecOutputs[state];
+		for (vector<int>::const_iterator it = outputs.begin(); it != outputs.end(); it++) {
+			if (spans[*it].pos == string::npos) {
+				uiRemaining--;
+
+				size_t posValue = pos + 1;
+				size_t posEnd = (*m_vecKeys[*it].cstrDelim ? findText(pstrData, posValue, m_vecKeys[*it].cstrDelim) : string::npos);
+				spans[*it].pos = posValue;
+				spans[*it].len = (posEnd != string::npos ? posEnd : len) - posValue;
+			}
+		}
+	}
+
+	for (size_t i=0; i<m_vecKeys.size(); i++) {
+		if (spans[i].pos == string::npos) {
+			spans[i].pos = 0;
+		}
+	}
+}
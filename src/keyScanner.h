@@ -0,0 +1,55 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_KEYSCANNER_H_
+#define MULTI2MACTIME_KEYSCANNER_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "processor.h"
+
+// Extracts the values of a fixed set of literal key markers (e.g. "src=", "dst=", " from ") from a line in a single
+// pass. The markers are compiled into an Aho-Corasick automaton when the scanner is constructed; scan() then walks
+// the line once and, for the first occurrence of each marker, records the span of the value that follows it up to
+// that marker's delimiter. This is equivalent to calling findSubString(line, pos, marker, delimiter) for every
+// marker, without rescanning the line for each one.
+//
+// An empty delimiter (or one that is never found) captures the rest of the line. Markers that do not appear in the
+// line return an empty span.
+
+struct keyDefinition {
+	const char* cstrKey;
+	const char* cstrDelim;
+};
+
+class keyScanner {
+	public:
+		keyScanner(const keyDefinition* pKeys, size_t count);
+
+		size_t getKeyCount() const { return m_vecKeys.size(); }
+		void scan(const string* pstrData, size_t pos, textSpan* spans) const;
+
+	private:
+		void compile();
+
+		vector<keyDefinition> m_vecKeys;
+		unsigned char m_classes[256];		// byte -> character class (0 for bytes that appear in no key)
+		size_t m_uiClassCount;
+		vector<int32_t> m_vecDelta;			// state * m_uiClassCount + class -> next state
+		vector<vector<int> > m_vecOutputs;	// state -> indices of keys ending in that state
+};
+
+#endif /*MULTI2MACTIME_KEYSCANNER_H_*/
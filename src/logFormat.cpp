@@ -0,0 +1,314 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "logFormat.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+using namespace std;
+
+#include "libtimeUtils/src/timeZoneCalculator.h"
+#include "libtimeUtils/src/timeUtils.h"
+#include "libdelimText/src/textFile.h"
+#include "libdelimText/src/textUtils.h"
+#include "misc/boost_lexical_cast_wrapper.hpp"
+
+// Splits a definition statement into identifiers/numbers, quoted strings (returned with a leading '"' so they can be
+// told apart from identifiers) and single punctuation characters.
+static bool tokenizeStatement(const string& strLine, vector<string>* pTokens) {
+	size_t pos = 0;
+	while (pos < strLine.length()) {
+		char ch = strLine[pos];
+		if (isspace(ch)) {
+			pos++;
+		} else if (ch == '#') {
+			break;
+		} else if (ch == '"') {
+			string strToken = "\"";
+			for (pos++; pos < strLine.length() && strLine[pos] != '"'; pos++) {
+				if (strLine[pos] == '\\' && pos + 1 < strLine.length()) {
+					pos++;
+					strToken += (strLine[pos] == 't' ? '\t' : strLine[pos]);
+				} else {
+					strToken += strLine[pos];
+				}
+			}
+			if (pos >= strLine.length()) {
+				return false;
+			}
+			pos++;
+			pTokens->push_back(strToken);
+		} else if (isalnum(ch) || ch == '_') {
+			size_t posEnd = pos;
+			while (posEnd < strLine.length() && (isalnum(strLine[posEnd]) || strLine[posEnd] == '_' || strLine[posEnd] == '-')) {
+				posEnd++;
+			}
+			pTokens->push_back(strLine.substr(pos, posEnd - pos));
+			pos = posEnd;
+		} else {
+			pTokens->push_back(string(1, ch));
+			pos++;
+		}
+	}
+	return true;
+}
+
+static inline bool isQuotedToken(const vector<string>& vecTokens, size_t i) {
+	return (i < vecTokens.size() && vecTokens[i].length() && vecTokens[i][0] == '"');
+}
+
+static inline bool isToken(const vector<string>& vecTokens, size_t i, const char* cstrToken) {
+	return (i < vecTokens.size() && vecTokens[i] == cstrToken);
+}
+
+logFormat::logFormat() : m_pKeyScanner(NULL), m_chDelimiter(','), m_chQualifier(0), m_iMaxField(-1), m_uiTimeInstrs(0) {
+}
+
+logFormat::~logFormat() {
+	delete m_pKeyScanner;
+}
+
+bool logFormat::load(string strFilename) {
+	bool rv = false;
+
+	textFile txtFileObj;
+	if (txtFileObj.open(strFilename)) {
+		vector<string> vecLines;
+		string strLine;
+		while (txtFileObj.getNextRow(&strLine)) {
+			vecLines.push_back(strLine);
+		}
+		rv = compile(vecLines);
+	} else {
+		LOG_ERROR("logFormat::load() Unable to open file (" << strFilename << ")");
+	}
+
+	return rv;
+}
+
+bool logFormat::compile(const vector<string>& vecLines) {
+	bool rv = true;
+
+	for (vector<string>::const_iterator it = vecLines.begin(); it != vecLines.end(); it++) {
+		if (!compileStatement(*it)) {
+			LOG_ERROR("logFormat::compile() Invalid statement (" << *it << ")");
+			rv = false;
+		}
+	}
+
+	// Move the time column statements to the front so rows outside --start/--end are rejected before anything else is
+	// extracted.
+	vector<logFormatInstr> vecTime, vecOther;
+	size_t posStatement = 0;
+	for (size_t i=0; i<m_vecProgram.size(); i++) {
+		if (m_vecProgram[i].uiOp == LOGFORMAT_OP_STORE) {
+			vector<logFormatInstr>* pTarget = (m_vecProgram[i].uiColumn >= MULTI2MAC_ATIME ? &vecTime : &vecOther);
+			pTarget->insert(pTarget->end(), m_vecProgram.begin() + posStatement, m_vecProgram.begin() + i + 1);
+			posStatement = i + 1;
+		}
+	}
+	m_uiTimeInstrs = vecTime.size();
+	m_vecProgram.swap(vecTime);
+	m_vecProgram.insert(m_vecProgram.end(), vecOther.begin(), vecOther.end());
+
+	m_vecKeys.clear();
+	for (size_t i=0; i<m_vecKeyMarkers.size(); i++) {
+		keyDefinition key = { m_vecKeyMarkers[i].c_str(), m_vecKeyDelims[i].c_str() };
+		m_vecKeys.push_back(key);
+	}
+	delete m_pKeyScanner;
+	m_pKeyScanner = (m_vecKeys.size() ? new keyScanner(&m_vecKeys[0], m_vecKeys.size()) : NULL);
+	m_vecKeySpans.resize(m_vecKeys.size());
+
+	DEBUG("logFormat::compile() " << m_vecProgram.size() << " instructions, " << m_vecKeys.size() << " keys, " << m_iMaxField + 1 << " fields");
+	return rv;
+}
+
+bool logFormat::compileStatement(const string& strLine) {
+	vector<string> vecTokens;
+	if (!tokenizeStatement(strLine, &vecTokens)) {
+		return false;
+	}
+	if (vecTokens.empty()) {
+		return true;
+	}
+
+	// Directives
+	if (vecTokens.size() == 2 && isQuotedToken(vecTokens, 1)) {
+		if (vecTokens[0] == "delimiter" && vecTokens[1].length() == 2) {
+			m_chDelimiter = vecTokens[1][1];
+			return true;
+		} else if (vecTokens[0] == "qualifier" && vecTokens[1].length() == 2) {
+			m_chQualifier = vecTokens[1][1];
+			return true;
+		} else if (vecTokens[0] == "skip") {
+			m_strSkip = vecTokens[1].substr(1);
+			return true;
+		}
+	}
+
+	// <COLUMN> = <part> [<part> ...] [unquote] [as epoch | as "<layout>"]
+	int iColumn = getColumnByName(vecTokens[0]);
+	if (iColumn < 0 || !isToken(vecTokens, 1, "=")) {
+		return false;
+	}
+
+	logFormatInstr instr;
+	instr.uiColumn = iColumn;
+	size_t i = 2;
+	while (i < vecTokens.size()) {
+		if (isQuotedToken(vecTokens, i)) {
+			instr.uiOp = LOGFORMAT_OP_LITERAL;
+			instr.uiArg = m_vecLiterals.size();
+			m_vecLiterals.push_back(vecTokens[i].substr(1));
+			i++;
+		} else if (vecTokens[i] == "key" && isToken(vecTokens, i + 1, "(") && isQuotedToken(vecTokens, i + 2) && isToken(vecTokens, i + 3, ",") && isQuotedToken(vecTokens, i + 4) && isToken(vecTokens, i + 5, ")")) {
+			string strMarker = vecTokens[i + 2].substr(1);
+			string strDelim = vecTokens[i + 4].substr(1);
+			instr.uiOp = LOGFORMAT_OP_KEY;
+			instr.uiArg = m_vecKeyMarkers.size();
+			for (size_t k=0; k<m_vecKeyMarkers.size(); k++) {
+				if (m_vecKeyMarkers[k] == strMarker && m_vecKeyDelims[k] == strDelim) {
+					instr.uiArg = k;
+				}
+			}
+			if (instr.uiArg == m_vecKeyMarkers.size()) {
+				m_vecKeyMarkers.push_back(strMarker);
+				m_vecKeyDelims.push_back(strDelim);
+			}
+			i += 6;
+		} else if (vecTokens[i] == "field" && isToken(vecTokens, i + 1, "(") && i + 2 < vecTokens.size() && isdigit(vecTokens[i + 2][0]) && isToken(vecTokens, i + 3, ")")) {
+			instr.uiOp = LOGFORMAT_OP_FIELD;
+			instr.uiArg = atoi(vecTokens[i + 2].c_str());
+			m_iMaxField = max(m_iMaxField, (int)instr.uiArg);
+			i += 4;
+		} else if (vecTokens[i] == "unquote") {
+			instr.uiOp = LOGFORMAT_OP_UNQUOTE;
+			instr.uiArg = 0;
+			i++;
+		} else if (vecTokens[i] == "as" && isToken(vecTokens, i + 1, "epoch") && iColumn >= MULTI2MAC_ATIME) {
+			instr.uiOp = LOGFORMAT_OP_TIME_EPOCH;
+			instr.uiArg = 0;
+			i += 2;
+		} else if (vecTokens[i] == "as" && isQuotedToken(vecTokens, i + 1) && iColumn >= MULTI2MAC_ATIME) {
+			instr.uiOp = LOGFORMAT_OP_TIME_LAYOUT;
+			instr.uiArg = m_vecLiterals.size();
+			m_vecLiterals.push_back(vecTokens[i + 1].substr(1));
+			i += 2;
+		} else {
+			return false;
+		}
+		m_vecProgram.push_back(instr);
+	}
+
+	instr.uiOp = LOGFORMAT_OP_STORE;
+	instr.uiArg = 0;
+	m_vecProgram.push_back(instr);
+
+	return true;
+}
+
+// Locates fields 0..uiMaxField without copying them; qualified fields keep their qualifiers (see 'unquote').
+void logFormat::splitFields(const string* pstrData, size_t uiMaxField) {
+	m_vecFieldSpans.clear();
+
+	size_t len = pstrData->length();
+	size_t pos = 0;
+	while (m_vecFieldSpans.size() <= uiMaxField && pos <= len) {
+		bool bQualified = false;
+		size_t posEnd = pos;
+		while (posEnd < len && (bQualified || (*pstrData)[posEnd] != m_chDelimiter)) {
+			if (m_chQualifier && (*pstrData)[posEnd] == m_chQualifier) {
+				bQualified = !bQualified;
+			}
+			posEnd++;
+		}
+		textSpan span = { pos, posEnd - pos };
+		m_vecFieldSpans.push_back(span);
+		pos = posEnd + 1;
+	}
+}
+
+void logFormat::process(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
+	if (m_strSkip.length() && pstrData->compare(0, m_strSkip.length(), m_strSkip) == 0) {
+		return;
+	}
+
+	if (m_pKeyScanner) {
+		m_pKeyScanner->scan(pstrData, 0, &m_vecKeySpans[0]);
+	}
+	if (m_iMaxField >= 0) {
+		splitFields(pstrData, m_iMaxField);
+	}
+
+	m_strValue.clear();
+	for (vector<logFormatInstr>::const_iterator it = m_vecProgram.begin(); it != m_vecProgram.end(); it++) {
+		if (m_uiTimeInstrs && it == m_vecProgram.begin() + m_uiTimeInstrs && !rowInTimeWindow(strFields)) {
+			for (int i=MULTI2MAC_ATIME; i<=MULTI2MAC_BTIME; i++) {
+				strFields[i].clear();
+			}
+			return;
+		}
+		switch (it->uiOp) {
+			case LOGFORMAT_OP_KEY:
+				m_strValue.append(*pstrData, m_vecKeySpans[it->uiArg].pos, m_vecKeySpans[it->uiArg].len);
+				break;
+
+			case LOGFORMAT_OP_FIELD:
+				if (it->uiArg < m_vecFieldSpans.size()) {
+					m_strValue.append(*pstrData, m_vecFieldSpans[it->uiArg].pos, m_vecFieldSpans[it->uiArg].len);
+				}
+				break;
+
+			case LOGFORMAT_OP_LITERAL:
+				m_strValue.append(m_vecLiterals[it->uiArg]);
+				break;
+
+			case LOGFORMAT_OP_UNQUOTE:
+				m_strValue = stripQualifiers(m_strValue, '"');
+				break;
+
+			case LOGFORMAT_OP_TIME_EPOCH:
+				if (m_strValue.length()) {
+					int32_t timeVal = strtol(m_strValue.c_str(), NULL, 10) + uiSkew;
+					m_strValue = (timeVal > 0 ? boost_lexical_cast_wrapper<string>(timeVal) : "");
+				}
+				break;
+
+			case LOGFORMAT_OP_TIME_LAYOUT:
+				if (m_strValue.length()) {
+					int32_t timeVal = getUnix32FromLayout(m_strValue, m_vecLiterals[it->uiArg], uiSkew, pTZCalc);
+					m_strValue = (timeVal > 0 ? boost_lexical_cast_wrapper<string>(timeVal) : "");
+				}
+				break;
+
+			case LOGFORMAT_OP_STORE:
+				strFields[it->uiColumn].swap(m_strValue);
+				m_strValue.clear();
+				break;
+		}
+	}
+}
+
+void processFormat(string* pstrData, logFormat* pFormat, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
+	DEBUG("processFormat()");
+	pFormat->process(pstrData, uiSkew, bNormalize, pTZCalc, strFields);
+}
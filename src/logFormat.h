@@ -0,0 +1,98 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_LOGFORMAT_H_
+#define MULTI2MACTIME_LOGFORMAT_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "processor.h"
+#include "keyScanner.h"
+
+// Plug-in log format definitions (--type format --custom1 <file>). A definition describes how to pull each of the
+// multi2mactime columns out of a line; it is compiled when loaded into a short bytecode program that process() runs
+// for every line. All key markers are compiled into a single keyScanner, so a line is scanned once regardless of how
+// many keys the definition uses.
+//
+// Definition syntax (one statement per line, '#' starts a comment):
+//
+//		delimiter ","						Field delimiter for field(n) references
+//		qualifier "\""						Text qualifier around delimited fields
+//		skip "#"								Ignore lines that start with the given text
+//		<COLUMN> = <part> [<part> ...] [unquote] [as epoch | as "<layout>"]
+//
+//	COLUMN is one of HASH, DETAIL, TYPE, LOG, FROM, TO, SIZE, ATIME, MTIME, CTIME, BTIME. Parts are concatenated:
+//
+//		key("<marker>", "<delimiter>")	Text following <marker> up to <delimiter> (see keyScanner)
+//		field(<n>)							The n'th (0-based) delimited field
+//		"<text>"								Literal text
+//
+// 'unquote' strips surrounding '"' qualifiers from the value. Time columns are converted with 'as epoch' (already a
+// Unix time) or 'as "<layout>"' using the same layout strings as timeZoneCalculator::createLocalTime(). Rows whose
+// DETAIL column is empty are dropped by main() as with the built-in parsers.
+
+#define LOGFORMAT_OP_KEY			1
+#define LOGFORMAT_OP_FIELD			2
+#define LOGFORMAT_OP_LITERAL		3
+#define LOGFORMAT_OP_UNQUOTE		4
+#define LOGFORMAT_OP_TIME_EPOCH	5
+#define LOGFORMAT_OP_TIME_LAYOUT	6
+#define LOGFORMAT_OP_STORE			7
+
+struct logFormatInstr {
+	u_int8_t uiOp;
+	u_int8_t uiColumn;
+	u_int16_t uiArg;
+};
+
+class logFormat {
+	public:
+		logFormat();
+		~logFormat();
+
+		bool load(string strFilename);
+		bool compile(const vector<string>& vecLines);
+		void process(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+
+	private:
+		logFormat(const logFormat&);
+		logFormat& operator=(const logFormat&);
+
+		bool compileStatement(const string& strLine);
+		void splitFields(const string* pstrData, size_t uiMaxField);
+
+		vector<logFormatInstr> m_vecProgram;
+		vector<string> m_vecLiterals;			// literals and time layouts, indexed by uiArg
+		vector<string> m_vecKeyMarkers;
+		vector<string> m_vecKeyDelims;
+		vector<keyDefinition> m_vecKeys;
+		keyScanner* m_pKeyScanner;
+
+		char m_chDelimiter;
+		char m_chQualifier;
+		string m_strSkip;
+		int m_iMaxField;
+		size_t m_uiTimeInstrs;					// leading instructions that produce the time columns
+
+		// Per-line scratch space, kept between calls to avoid reallocating
+		vector<textSpan> m_vecKeySpans;
+		vector<textSpan> m_vecFieldSpans;
+		string m_strValue;
+};
+
+void processFormat(string* pstrData, logFormat* pFormat, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+
+#endif /*MULTI2MACTIME_LOGFORMAT_H_*/
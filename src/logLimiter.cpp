@@ -0,0 +1,156 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+bool bLogLimiterRunning = false;
+mutex mutexLogOutput;
+
+static mutex mutexLimiter;
+static condition_variable cvLimiter;
+static deque<pair<logSite*, string> > dequeLimiter;		// verbatim samples waiting to be written
+static vector<logSite*> vecLimiterSites;
+static thread* pLimiterThread = NULL;
+static bool bLimiterStop = false;
+
+logSite::logSite(int iLevel, const char* cstrFile, int iLine, const char* cstrReason) : m_iLevel(iLevel), m_cstrFile(cstrFile), m_iLine(iLine),
+		m_cstrReason(cstrReason), m_uiHits(0), m_bWantSample(true), m_uiSampled(0), m_uiSummarized(0) {
+	m_cstrSample[0] = '\0';
+	const char* cstrSlash = strrchr(cstrFile, '/');
+	if (cstrSlash) {
+		m_cstrFile = cstrSlash + 1;
+	}
+
+	lock_guard<mutex> lock(mutexLimiter);
+	vecLimiterSites.push_back(this);
+}
+
+void logSite::report(const string& strDetail) {
+	if (!bLogLimiterRunning) {
+		write(strDetail);
+		return;
+	}
+
+	lock_guard<mutex> lock(mutexLimiter);
+	if (m_uiSampled < LOGLIMITER_SAMPLES) {
+		m_uiSampled++;
+		dequeLimiter.push_back(make_pair(this, strDetail));
+		cvLimiter.notify_one();
+	} else {
+		// Kept for the next summary
+		strncpy(m_cstrSample, strDetail.c_str(), sizeof(m_cstrSample) - 1);
+		m_cstrSample[sizeof(m_cstrSample) - 1] = '\0';
+	}
+}
+
+void logSite::write(const string& strDetail) {
+	if (m_iLevel == LOGLIMITER_WARNING) {
+		LOG_WARNING(m_cstrReason << strDetail);
+	} else {
+		LOG_ERROR(m_cstrReason << strDetail);
+	}
+}
+
+// Logs the hits since the last summary that were not written verbatim, with the latest sample; bFinal adds the
+// total for a call site that was limited at all.
+void logSite::summarize(bool bFinal) {
+	u_int64_t uiHits = m_uiHits.load();
+	u_int64_t uiSuppressed = (uiHits > LOGLIMITER_SAMPLES ? uiHits - LOGLIMITER_SAMPLES : 0);
+
+	if (uiSuppressed > m_uiSummarized) {
+		stringstream ssSummary;
+		ssSummary << " [" << uiSuppressed - m_uiSummarized << " more at " << m_cstrFile << ":" << m_iLine << "]" << m_cstrSample;
+		write(ssSummary.str());
+		m_uiSummarized = uiSuppressed;
+		m_cstrSample[0] = '\0';
+		m_bWantSample = true;
+	}
+
+	if (bFinal && uiSuppressed) {
+		stringstream ssTotal;
+		ssTotal << " [" << uiHits << " in total at " << m_cstrFile << ":" << m_iLine << ", " << LOGLIMITER_SAMPLES << " shown]";
+		write(ssTotal.str());
+	}
+}
+
+static void limiterLoop() {
+	unique_lock<mutex> lock(mutexLimiter);
+	chrono::steady_clock::time_point next = chrono::steady_clock::now() + chrono::milliseconds(LOGLIMITER_INTERVAL_MS);
+	while (true) {
+		cvLimiter.wait_until(lock, next, [] { return bLimiterStop || !dequeLimiter.empty(); });
+
+		while (!dequeLimiter.empty()) {
+			dequeLimiter.front().first->write(dequeLimiter.front().second);
+			dequeLimiter.pop_front();
+		}
+
+		if (bLimiterStop || chrono::steady_clock::now() >= next) {
+			for (vector<logSite*>::iterator it = vecLimiterSites.begin(); it != vecLimiterSites.end(); it++) {
+				(*it)->summarize(bLimiterStop);
+			}
+			next = chrono::steady_clock::now() + chrono::milliseconds(LOGLIMITER_INTERVAL_MS);
+		}
+
+		if (bLimiterStop) {
+			break;
+		}
+	}
+}
+
+void logLimiterStart() {
+	if (pLimiterThread) {
+		return;
+	}
+	bLimiterStop = false;
+	bLogLimiterRunning = true;
+	pLimiterThread = new thread(limiterLoop);
+
+	// Also flush on exit(EXIT_FAILURE) paths
+	static bool bRegistered = false;
+	if (!bRegistered) {
+		bRegistered = (atexit(logLimiterStop) == 0);
+	}
+}
+
+// Writes what is queued and the final summaries; call before logClose()
+void logLimiterStop() {
+	if (!pLimiterThread) {
+		return;
+	}
+	{
+		lock_guard<mutex> lock(mutexLimiter);
+		bLimiterStop = true;
+	}
+	cvLimiter.notify_one();
+	pLimiterThread->join();
+	delete pLimiterThread;
+	pLimiterThread = NULL;
+	bLogLimiterRunning = false;
+}
@@ -0,0 +1,95 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_LOGLIMITER_H_
+#define MULTI2MACTIME_LOGLIMITER_H_
+
+#include "misc/errMsgs.h"
+
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+using namespace std;
+
+// Rate limited ERROR()/WARNING() for messages that can repeat once per row (a bad timestamp, a missing field). A
+// corrupt or mis-typed file can otherwise produce millions of synchronous writes to stderr or the --log file.
+//
+// Each ROW_ERROR()/ROW_WARNING() call site counts its hits. The first LOGLIMITER_SAMPLES are logged verbatim; after
+// that a hit costs an atomic increment and the message is not even formatted, except for one sample per interval.
+// Messages are written by a background thread, which every LOGLIMITER_INTERVAL_MS logs one summary per busy call site
+// (reason, count, file:line and the sample) and, at logLimiterStop(), the total for every call site that was limited.
+//
+// Until logLimiterStart() (e.g. in the benchmarks) every hit is passed straight to ERROR()/WARNING().
+//
+//		ROW_ERROR("getIEFTime() Failed to convert non-empty string to time value", " (" << strTime << ")");
+//
+// The limiter thread, the --progress thread and the main thread all write to stderr or the --log file, so every
+// message goes out under mutexLogOutput: LOG_ERROR()/LOG_WARNING() in place of ERROR()/WARNING(), and LOG_LOCKED()
+// around anything else written to stderr while those threads run.
+
+#define LOGLIMITER_ERROR				0
+#define LOGLIMITER_WARNING			1
+
+#define LOGLIMITER_SAMPLES			5			// per call site, logged verbatim
+#define LOGLIMITER_INTERVAL_MS		1000
+#define LOGLIMITER_SAMPLE_LENGTH		256
+
+extern bool bLogLimiterRunning;
+extern mutex mutexLogOutput;
+
+#define LOG_LOCKED(x)			{ lock_guard<mutex> lockLogOutput(mutexLogOutput); x; }
+#define LOG_ERROR(x)				LOG_LOCKED(ERROR(x))
+#define LOG_WARNING(x)			LOG_LOCKED(WARNING(x))
+
+void logLimiterStart();
+void logLimiterStop();
+
+// One per call site, as a function static; trivially destructible so that it is still intact when logLimiterStop()
+// runs from atexit().
+class logSite {
+	public:
+		logSite(int iLevel, const char* cstrFile, int iLine, const char* cstrReason);
+
+		bool hit() {
+			return (++m_uiHits <= LOGLIMITER_SAMPLES || !bLogLimiterRunning || (m_bWantSample.load(memory_order_relaxed) && m_bWantSample.exchange(false)));
+		}
+		void report(const string& strDetail);
+
+		// Background thread, under its mutex
+		void write(const string& strDetail);
+		void summarize(bool bFinal);
+
+	private:
+		logSite(const logSite&);
+		logSite& operator=(const logSite&);
+
+		int m_iLevel;
+		const char* m_cstrFile;
+		int m_iLine;
+		const char* m_cstrReason;
+		atomic<u_int64_t> m_uiHits;
+		atomic<bool> m_bWantSample;
+
+		// Background thread, under its mutex
+		u_int64_t m_uiSampled;
+		u_int64_t m_uiSummarized;
+		char m_cstrSample[LOGLIMITER_SAMPLE_LENGTH];
+};
+
+#define ROW_LOG(level, reason, x) { static logSite siteRowLog(level, __FILE__, __LINE__, reason); if (siteRowLog.hit()) { stringstream ssRowLog; ssRowLog << x; siteRowLog.report(ssRowLog.str()); } }
+#define ROW_ERROR(reason, x)		ROW_LOG(LOGLIMITER_ERROR, reason, x)
+#define ROW_WARNING(reason, x)	ROW_LOG(LOGLIMITER_WARNING, reason, x)
+
+#endif /*MULTI2MACTIME_LOGLIMITER_H_*/
@@ -0,0 +1,158 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Prints the rows of a time ordered body file (multi2mactime --sort/--merge-sorted --index) that fall within a time
+// range, seeking straight to the range with the sparse index instead of reading the whole file.
+
+// #define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+using namespace std;
+
+#include "popt.h"
+#include "misc/poptUtils.h"
+#include "timeIndex.h"
+
+#define M2MSLICE_TIME_FIELD	7		// ATIME; MTIME, CTIME and CRTIME follow
+
+// Body file times are Unix (UTC) times, so dates given here are UTC as well.
+static int64_t getUnixFromString(string strTime) {
+	if (strTime.find_first_not_of("0123456789") == string::npos) {
+		return strtoll(strTime.c_str(), NULL, 10);
+	}
+	replace(strTime.begin(), strTime.end(), 'T', ' ');
+
+	struct tm tmTime;
+	memset(&tmTime, 0, sizeof(tmTime));
+	const char* cstrEnd = strptime(strTime.c_str(), (strTime.find(' ') != string::npos ? "%Y-%m-%d %H:%M:%S" : "%Y-%m-%d"), &tmTime);
+	if (!cstrEnd || *cstrEnd) {
+		return -1;
+	}
+	return timegm(&tmTime);
+}
+
+// Earliest non-zero time of the row, as multi2mactime sorts by, or 0 if it has none.
+static u_int32_t getRowTime(const char* cstrRow) {
+	u_int32_t rv = 0;
+	int iField = 0;
+	for (const char* p = cstrRow; *p && *p != '\n'; p++) {
+		if (*p == '|') {
+			if (++iField >= M2MSLICE_TIME_FIELD) {
+				u_int32_t uiTime = strtoul(p + 1, NULL, 10);
+				if (uiTime && (!rv || uiTime < rv)) {
+					rv = uiTime;
+				}
+			}
+		}
+	}
+	return rv;
+}
+
+int main(int argc, const char** argv) {
+	int rv = EXIT_FAILURE;
+
+	string strIndex = "";
+	string strStart = "";
+	string strEnd = "";
+
+	struct poptOption optionsTable[] = {
+		{"index",		'i',	POPT_ARG_STRING,	NULL,	10,	"Index written by multi2mactime --index. Defaults to <body file>.idx.", "file"},
+		{"start",		 0,	POPT_ARG_STRING,	NULL,	20,	"Only output rows at or after this time (Unix time, 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS' in UTC).", "time"},
+		{"end",			 0,	POPT_ARG_STRING,	NULL,	30,	"Only output rows at or before this time (same formats as --start).", "time"},
+		{"version",		 0,	POPT_ARG_NONE,		NULL,	100,	"Display version.", NULL},
+		POPT_AUTOHELP
+		POPT_TABLEEND
+	};
+	poptContext optCon = poptGetContext(NULL, argc, argv, optionsTable, 0);
+	poptSetOtherOptionHelp(optCon, "[options] <body file>");
+
+	int iOption = poptGetNextOpt(optCon);
+	while (iOption >= 0) {
+		switch (iOption) {
+			case 10:
+				strIndex = poptGetOptArg(optCon);
+				break;
+			case 20:
+				strStart = poptGetOptArg(optCon);
+				break;
+			case 30:
+				strEnd = poptGetOptArg(optCon);
+				break;
+			case 100:
+				version(PACKAGE, VERSION);
+				exit(EXIT_SUCCESS);
+				break;
+		}
+		iOption = poptGetNextOpt(optCon);
+	}
+
+	if (iOption != -1) {
+		usage(optCon, poptBadOption(optCon, POPT_BADOPTION_NOALIAS), poptStrerror(iOption));
+		exit(EXIT_FAILURE);
+	}
+
+	const char* cstrFilename = poptGetArg(optCon);
+	if (!cstrFilename) {
+		usage(optCon, "Missing body file", "");
+		exit(EXIT_FAILURE);
+	}
+	string strFilename = cstrFilename;
+	if (strIndex == "") {
+		strIndex = strFilename + ".idx";
+	}
+
+	int64_t timeStart = (strStart != "" ? getUnixFromString(strStart) : 0);
+	int64_t timeEnd = (strEnd != "" ? getUnixFromString(strEnd) : 0xffffffffLL);
+	if (timeStart < 0 || timeEnd < 0 || timeEnd < timeStart) {
+		usage(optCon, "Invalid time range", "--start/--end must be a Unix time, 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS' with --start <= --end");
+		exit(EXIT_FAILURE);
+	}
+
+	u_int64_t uiOffset = 0;
+	if (timeIndex::lookup(strIndex, timeStart, &uiOffset)) {
+		FILE* pBody = fopen(strFilename.c_str(), "r");
+		if (pBody) {
+			if (fseeko(pBody, uiOffset, SEEK_SET) == 0) {
+				DEBUG("Seeking to " << uiOffset << " for " << timeStart);
+				char* cstrRow = NULL;
+				size_t uiSize = 0;
+				while (getline(&cstrRow, &uiSize, pBody) > 0) {
+					u_int32_t uiTime = getRowTime(cstrRow);
+					if (uiTime > timeEnd) {
+						break;
+					} else if (uiTime && uiTime >= timeStart) {
+						fputs(cstrRow, stdout);
+					}
+				}
+				free(cstrRow);
+				rv = EXIT_SUCCESS;
+			} else {
+				ERROR(strFilename << ": Unable to seek to offset " << uiOffset);
+			}
+			fclose(pBody);
+		} else {
+			ERROR(strFilename << ": Unable to open file");
+		}
+	}
+
+	poptFreeContext(optCon);
+	return rv;
+}
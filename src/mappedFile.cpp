@@ -0,0 +1,134 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "mappedFile.h"
+
+#include <string>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+using namespace std;
+
+mappedFile::mappedFile() : m_pData(NULL), m_uiSize(0), m_pos(0) {
+}
+
+mappedFile::~mappedFile() {
+	close();
+}
+
+// Fails (quietly) for anything that is not a regular file, so callers can fall back to a sequential reader.
+bool mappedFile::open(string strFilename) {
+	close();
+
+	int fd = ::open(strFilename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	bool rv = false;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		m_uiSize = st.st_size;
+		if (m_uiSize == 0) {
+			rv = true;
+		} else {
+			void* p = mmap(NULL, m_uiSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				madvise(p, m_uiSize, MADV_SEQUENTIAL);
+				m_pData = (const char*)p;
+				rv = true;
+			} else {
+				DEBUG("mappedFile::open() Unable to mmap " << strFilename);
+				m_uiSize = 0;
+			}
+		}
+	}
+	::close(fd);
+
+	return rv;
+}
+
+void mappedFile::close() {
+	if (m_pData) {
+		munmap((void*)m_pData, m_uiSize);
+	}
+	m_pData = NULL;
+	m_uiSize = 0;
+	m_pos = 0;
+}
+
+size_t mappedFile::getLineEnd(size_t pos) const {
+	const char* p = (const char*)memchr(m_pData + pos, '\n', m_uiSize - pos);
+	return (p ? p - m_pData : m_uiSize);
+}
+
+bool mappedFile::getNextRow(string* pstrRow) {
+	if (m_pos >= m_uiSize) {
+		return false;
+	}
+
+	size_t posEnd = getLineEnd(m_pos);
+	pstrRow->assign(m_pData + m_pos, posEnd - m_pos);
+	m_pos = posEnd + 1;
+	return true;
+}
+
+size_t mappedFile::seekTime(int32_t timeStart, rowTimeFunc fnTime, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
+	// Every line starting before lo is known to be earlier than timeStart; the first line at or after timeStart
+	// starts before hi (or is the first timed line after it).
+	size_t lo = 0;
+	size_t hi = m_uiSize;
+	size_t uiProbes = 0;
+	string strRow;
+
+	// The bisection touches a page here and there; readahead only helps once rows are read from lo onwards
+	if (m_pData) {
+		madvise((void*)m_pData, m_uiSize, MADV_RANDOM);
+	}
+
+	while (hi - lo > MAPPEDFILE_SEEK_LINEAR) {
+		size_t mid = lo + (hi - lo) / 2;
+		size_t pos = getLineEnd(mid) + 1;
+
+		int32_t timeVal = -1;
+		while (pos < hi && timeVal <= 0) {
+			size_t posEnd = getLineEnd(pos);
+			strRow.assign(m_pData + pos, posEnd - pos);
+			timeVal = fnTime(&strRow, uiSkew, pTZCalc);
+			uiProbes++;
+			if (timeVal <= 0) {
+				pos = posEnd + 1;
+			}
+		}
+
+		if (timeVal > 0 && timeVal < timeStart) {
+			lo = pos;
+		} else {
+			hi = mid;
+		}
+	}
+
+	DEBUG("mappedFile::seekTime() " << timeStart << " at offset " << lo << " after " << uiProbes << " probes");
+	if (m_pData) {
+		madvise((void*)m_pData, m_uiSize, MADV_SEQUENTIAL);
+	}
+	m_pos = lo;
+	return lo;
+}
@@ -0,0 +1,57 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_MAPPEDFILE_H_
+#define MULTI2MACTIME_MAPPEDFILE_H_
+
+#include <string>
+using namespace std;
+
+#include "processor.h"
+
+// Memory-mapped line reader for regular files that are known to be in time order (--ordered). seekTime() bisects the
+// file on line boundaries, using a parser's rowTimeFunc to read the time of the first timed line after each probe,
+// and positions the reader at (or shortly before) the first line at or after the requested time. Only O(log n)
+// lines are examined; the final span below MAPPEDFILE_SEEK_LINEAR bytes is left to the normal window filter.
+//
+// Lines without a decodable time are skipped over while probing, so untimed lines before the window are not output.
+
+#define MAPPEDFILE_SEEK_LINEAR	(64 * 1024)
+
+class mappedFile {
+	public:
+		mappedFile();
+		~mappedFile();
+
+		bool open(string strFilename);
+		void close();
+		bool getNextRow(string* pstrRow);
+		size_t seekTime(int32_t timeStart, rowTimeFunc fnTime, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
+
+		// Offset of the next line, and back to one (--checkpoint/--resume)
+		size_t getOffset() const { return m_pos; }
+		void seekOffset(size_t pos) { m_pos = (pos < m_uiSize ? pos : m_uiSize); }
+
+	private:
+		mappedFile(const mappedFile&);
+		mappedFile& operator=(const mappedFile&);
+
+		size_t getLineEnd(size_t pos) const;
+
+		const char* m_pData;
+		size_t m_uiSize;
+		size_t m_pos;
+};
+
+#endif /*MULTI2MACTIME_MAPPEDFILE_H_*/
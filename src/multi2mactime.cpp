@@ -18,6 +18,9 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <queue>
+#include <functional>
 #include <algorithm>
 using namespace std;
 
@@ -25,10 +28,256 @@ using namespace std;
 #include "misc/poptUtils.h"
 #include "misc/errMsgs.h"
 #include "processor.h"
+#include "syslog.h"
+#include "logFormat.h"
+#include "regexMatcher.h"
+#include "bodySorter.h"
+#include "mappedFile.h"
+#include "columnWriter.h"
+#include "timeIndex.h"
+#include "rowDeduplicator.h"
+#include "compressedOutput.h"
+#include "sqliteWriter.h"
+#include "partitionWriter.h"
+#include "runStats.h"
+#include "spanTracer.h"
+#include "logLimiter.h"
+#include "progressReporter.h"
+#include "checkpoint.h"
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
 #include "libdelimText/src/textFile.h"
 
+// Everything the per-line parsers need besides the line itself.
+struct processorContext {
+	string strType;
+	u_int16_t uiYear;
+	u_int32_t uiSkew;
+	bool bNormalize;
+	timeZoneCalculator* pTZCalc;
+	logFormat* pFormat;
+	regexMatcher* pRegex;
+	string strCustom2;
+	u_int64_t* puiSyslogCounts;
+	size_t uiParser;				// of the last row, for --stats: the syslog class with auto-syslog, otherwise 0 (the --type)
+	rowTimeFunc fnOrderedTime;		// set with --ordered for types that have a cheap time extractor
+	int32_t timeEnd;
+};
+
+// Types whose lines carry a time that can be read without a full parse; used to seek/stop in --ordered inputs.
+// Juniper is left out: its start_time= is when the session began, so lines are not in that order.
+static rowTimeFunc getRowTimeFunc(string strType) {
+	if (strType == "squidw3c") {
+		return getSquidW3cTime;
+	} else if (strType == "fortg1k5") {
+		return getFortiGate1K5Time;
+	}
+	return NULL;
+}
+
+// In a time ordered input, a line the parser rejected that is already past --end means the rest of the input is too.
+static bool pastTimeWindow(processorContext* pContext, string* pstrData, string* strFields) {
+	return (pContext->fnOrderedTime && strFields[MULTI2MAC_DETAIL].length() == 0 && pContext->fnOrderedTime(pstrData, pContext->uiSkew, pContext->pTZCalc) > pContext->timeEnd);
+}
+
+static void processRow(processorContext* pContext, string* pstrData, string* pstrHeader, string* pstrFilename, string* strFields, string* strSecondary) {
+	DEBUG("strData: " << *pstrData);
+
+	if (pContext->strType == "squidw3c") {
+		processSquidW3c(pstrData, pContext->uiYear, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, strSecondary);
+	} else if (pContext->strType == "symantec") {
+		processSymantec(pstrData, pContext->uiYear, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "ipfw") {
+		strFields[MULTI2MAC_LOG] = "--------ipfw";
+		strFields[MULTI2MAC_DETAIL] = "Not Yet Implemented";
+	} else if (pContext->strType == "pf") {
+		strFields[MULTI2MAC_LOG] = "----------pf";
+		strFields[MULTI2MAC_DETAIL] = "Not Yet Implemented";
+	} else if (pContext->strType == "pix") {
+		processPIX(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "auto-syslog") {
+		// Mixed-source syslog; route each line to the parser for the device that generated it.
+		syslogHeader header;
+		int iClass = classifySyslog(pstrData, &header);
+		pContext->puiSyslogCounts[iClass]++;
+		pContext->uiParser = iClass;
+		switch (iClass) {
+			case SYSLOG_CLASS_PIX:
+				processPIX(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, &header);
+				break;
+			case SYSLOG_CLASS_JUNIPER:
+				processJuniper(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, &header);
+				break;
+			case SYSLOG_CLASS_SYMANTEC:
+				processSymantec(pstrData, pContext->uiYear, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, &header);
+				break;
+			case SYSLOG_CLASS_FORTIGATE:
+				processFortiGateSyslog(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, &header);
+				break;
+			default:
+				break;
+		}
+	} else if (pContext->strType == "juniper") {
+		processJuniper(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "custfsbt") {
+		processCustomFSBT(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "custfsem") {
+		processCustomFSEM(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "cusvpns1") {
+		processCustomVPN_S1(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "fortg1k5") {
+		processFortiGate1K5(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "hirsch") {
+		processHirsch(pstrData, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "griffeye") {
+		processGriffeyeCSV(pstrData, pstrHeader, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "ief") {
+		processIEF(pstrData, pstrHeader, pstrFilename, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, strSecondary);
+	} else if (pContext->strType == "notes") {
+		processNotes(pstrData, pstrHeader, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "exiftool") {
+		processExifTool(pstrData, pstrHeader, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields, strSecondary);
+	} else if (pContext->strType == "format") {
+		processFormat(pstrData, pContext->pFormat, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else if (pContext->strType == "regex") {
+		processRegex(pstrData, pContext->pRegex, pContext->strCustom2, pContext->uiSkew, pContext->bNormalize, pContext->pTZCalc, strFields);
+	} else {
+		strFields[MULTI2MAC_LOG] = "-----unknown";
+		strFields[MULTI2MAC_DETAIL] = "Unknown Type";
+	}
+}
+
+// --start/--end values; dates and times are interpreted in the --timezone zone like the log times themselves.
+static int32_t getUnix32FromWindowString(string strTime, timeZoneCalculator* pTZCalc) {
+	if (strTime.find_first_not_of("0123456789") == string::npos) {
+		return strtol(strTime.c_str(), NULL, 10);
+	}
+	replace(strTime.begin(), strTime.end(), 'T', ' ');
+	return getUnix32FromLayout(strTime, (strTime.find(' ') != string::npos ? "%Y-%m-%d %H:%M:%S" : "%Y-%m-%d"), 0, pTZCalc);
+}
+
+// Where finished rows go; unset members are not in use.
+struct outputContext {
+	rowDeduplicator* pDedup;
+	columnWriter* pColumns;
+	sqliteWriter* pSQLite;
+	partitionWriter* pPartition;
+	bodySorter* pSorter;
+	timeIndex* pIndex;
+};
+
+static void outputRow(string* strFields, outputContext* pOutput) {
+	traceStage stage(SPANTRACER_STAGE_OUTPUT);
+	if (pOutput->pDedup && pOutput->pDedup->isDuplicate(strFields)) {
+		return;
+	}
+
+	if (pOutput->pColumns) {
+		if (!pOutput->pColumns->add(strFields)) {
+			exit(EXIT_FAILURE);
+		}
+	} else if (pOutput->pSQLite) {
+		if (!pOutput->pSQLite->add(strFields)) {
+			exit(EXIT_FAILURE);
+		}
+	} else if (pOutput->pPartition) {
+		if (!pOutput->pPartition->add(strFields)) {
+			exit(EXIT_FAILURE);
+		}
+	} else if (pOutput->pSorter) {
+		if (!pOutput->pSorter->add(strFields)) {
+			delete pOutput->pSorter;		// removes any spilled runs
+			exit(EXIT_FAILURE);
+		}
+	} else {
+		string strRow;
+		formatBodyRow(strFields, &strRow);
+		cout << strRow;
+		if (pOutput->pIndex) {
+			pOutput->pIndex->addRow(getBodyRowTime(strFields), strRow.length());
+		}
+	}
+}
+
+struct mergeRow {
+	u_int32_t uiTime;
+	string strFields[11];
+};
+
+// One input of --merge-sorted; lines are only read and converted as the merge consumes the rows before them.
+struct mergeStream {
+	textFile* pFile;
+	mappedFile* pMapped;			// used instead of pFile when seeking with --ordered
+	string strFilename;
+	string strHeader;
+	deque<mergeRow> rows;
+	u_int64_t uiLine;
+	u_int32_t uiLastTime;
+	u_int64_t uiOutOfOrder;
+	runStats* pStats;
+	size_t uiStatsFile;
+	progressReporter* pProgress;
+};
+
+static void queueMergeRow(mergeStream* pStream, string* strFields) {
+	mergeRow row;
+	row.uiTime = getBodyRowTime(strFields);
+	if (!row.uiTime) {
+		row.uiTime = pStream->uiLastTime;		// untimed rows stay next to their neighbours
+	} else if (row.uiTime < pStream->uiLastTime) {
+		if (!pStream->uiOutOfOrder++) {
+			LOG_WARNING(pStream->strFilename << ": Line " << pStream->uiLine << " is out of time order; merged output will not be fully ordered (use --sort)");
+		}
+	} else {
+		pStream->uiLastTime = row.uiTime;
+	}
+	for (int i=0; i<11; i++) {
+		row.strFields[i].swap(strFields[i]);
+	}
+	pStream->rows.push_back(row);
+}
+
+// Reads until the stream has at least one row queued or is exhausted.
+static void fillMergeStream(mergeStream* pStream, processorContext* pContext) {
+	string strData;
+	string strFields[11];
+	string strSecondary[11];
+	while (pStream->rows.empty() && (pStream->pMapped ? pStream->pMapped->getNextRow(&strData) : pStream->pFile->getNextRow(&strData))) {
+		pStream->uiLine++;
+		u_int64_t uiTimeFailures = getTimeFailures();
+		{
+			traceStage stage(SPANTRACER_STAGE_PARSE);
+			processRow(pContext, &strData, &pStream->strHeader, &pStream->strFilename, strFields, strSecondary);
+		}
+		if (pStream->pStats) {
+			pStream->pStats->addRow(pStream->uiStatsFile, pContext->uiParser, strData.length() + 1, strFields[MULTI2MAC_DETAIL].length() == 0, getTimeFailures() - uiTimeFailures);
+		}
+		if (pStream->pProgress) {
+			pStream->pProgress->addRow(strData.length() + 1);
+		}
+		if (pastTimeWindow(pContext, &strData, strFields)) {
+			break;
+		}
+		if (strFields[MULTI2MAC_DETAIL].length() > 0 && rowInTimeWindow(strFields)) {
+			queueMergeRow(pStream, strFields);
+			if (pStream->pStats) {
+				pStream->pStats->addEmitted(pStream->uiStatsFile, pContext->uiParser, false);
+			}
+		}
+		if (strSecondary[MULTI2MAC_DETAIL].length() > 0 && rowInTimeWindow(strSecondary)) {
+			queueMergeRow(pStream, strSecondary);
+			if (pStream->pStats) {
+				pStream->pStats->addEmitted(pStream->uiStatsFile, pContext->uiParser, true);
+			}
+		}
+		for (int i=0; i<11; i++) {
+			strFields[i] = "";
+			strSecondary[i] = "";
+		}
+		traceEndRow();
+	}
+}
+
 int main(int argc, const char** argv) {
 	int rv = EXIT_FAILURE;
 
@@ -43,6 +292,46 @@ int main(int argc, const char** argv) {
 	bool bNormalize = false;
 	bool bHTMLDecode = false;
 	string strLog;
+	u_int64_t uiSyslogCounts[SYSLOG_CLASS_COUNT] = {0};
+	logFormat format;
+	regexMatcher regex;
+	bool bSort = false;
+	u_int64_t uiSortMemory = BODYSORTER_DEFAULT_MEMORY;
+	string strTempDir = "";
+	bodySorter* pSorter = NULL;
+	string strBinary = "";
+	columnWriter* pColumns = NULL;
+	string strIndex = "";
+	timeIndex* pIndex = NULL;
+	bool bDedup = false;
+	u_int32_t uiDedupHorizon = ROWDEDUPLICATOR_DEFAULT_HORIZON;
+	rowDeduplicator* pDedup = NULL;
+	string strCompress = "";
+	u_int32_t uiCompressThreads = 0;
+	compressedOutput* pCompressed = NULL;
+	streambuf* pCoutBuffer = NULL;
+	string strOutput = "";
+	sqliteWriter* pSQLite = NULL;
+	string strPartition = "";
+	u_int32_t uiPartitionFiles = PARTITIONWRITER_DEFAULT_FILES;
+	partitionWriter* pPartition = NULL;
+	string strStats = "";
+	string strStatsPrometheus = "";
+	runStats* pStats = NULL;
+	string strTrace = "";
+	bool bProgress = false;
+	string strProgressFile = "";
+	progressReporter* pProgress = NULL;
+	string strCheckpoint = "";
+	bool bResume = false;
+	u_int32_t uiCheckpointInterval = CHECKPOINT_DEFAULT_INTERVAL;
+	checkpoint* pCheckpoint = NULL;
+	bool bMergeSorted = false;
+	string strStart = "";
+	string strEnd = "";
+	int32_t timeStart = 0;
+	int32_t timeEnd = 0x7fffffff;
+	bool bOrdered = false;
 
 	struct poptOption optionsTable[] = {
 		{"type",			't',	POPT_ARG_STRING,	NULL,	10,	"Format for data.", "type"},
@@ -54,6 +343,30 @@ int main(int argc, const char** argv) {
 		//{"html-decode",'h',	POPT_ARG_NONE,		NULL, 60, 	"Execute multipass decoding of HTML encoded strings. Provides easier readability of URLs w/in URLs."},
 		{"custom1",		 0,	POPT_ARG_STRING,	NULL,	70,	"Custom value applicable to certain types of data.", "custom1"},
 		{"custom2",		 0,	POPT_ARG_STRING,	NULL,	80,	"Custom value applicable to certain types of data.", "custom2"},
+		{"sort",			 0,	POPT_ARG_NONE,		NULL,	90,	"Output rows in time order (earliest of the row's times) instead of input order."},
+		{"sort-memory", 0,	POPT_ARG_INT,		NULL,	91,	"Memory to use for --sort before spilling sorted runs to disk. Defaults to 256.", "MB"},
+		{"start",		 0,	POPT_ARG_STRING,	NULL,	94,	"Only output rows at or after this time (Unix time, 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS' in --timezone).", "time"},
+		{"end",			 0,	POPT_ARG_STRING,	NULL,	95,	"Only output rows at or before this time (same formats as --start).", "time"},
+		{"merge-sorted",0,	POPT_ARG_NONE,		NULL,	93,	"Inputs are each already in time order; merge them into a single time ordered output without a full sort."},
+		{"ordered",		 0,	POPT_ARG_NONE,		NULL,	96,	"Inputs are each already in time order; with --start/--end, seek to the window instead of reading every line (squidw3c, fortg1k5). Implied by --merge-sorted."},
+		{"binary",		 0,	POPT_ARG_STRING,	NULL,	97,	"Write a binary columnar timeline to this file instead of the text body file to stdout.", "file"},
+		{"index",		 0,	POPT_ARG_STRING,	NULL,	98,	"Write a sparse time index of the output to this file (requires --sort or --merge-sorted); see m2mslice.", "file"},
+		{"dedup",		 0,	POPT_ARG_NONE,		NULL,	99,	"Drop rows identical to a row already output within the --dedup-horizon. Across inputs whose times overlap, use with --merge-sorted."},
+		{"dedup-horizon",0,	POPT_ARG_INT,		NULL,	101,	"How far apart in time (and input order) duplicates are still detected; bounds --dedup memory. Defaults to 3600.", "seconds"},
+		{"compress",	 0,	POPT_ARG_STRING,	NULL,	102,	"Compress the body output written to stdout (gzip, or zstd if built with libzstd).", "codec"},
+		{"compress-threads",0,POPT_ARG_INT,	NULL,	103,	"Threads to use for --compress. Defaults to the number of CPUs.", "threads"},
+		{"output",		 0,	POPT_ARG_STRING,	NULL,	104,	"Write rows to this sink instead of the text body file to stdout: sqlite:<database> (table 'timeline').", "sink"},
+		{"partition",	 0,	POPT_ARG_STRING,	NULL,	105,	"Split the body output into one file per hour, day or LOG-SRC in a directory (e.g. 'day:/cases/1/timeline').", "hour|day|log-src:dir"},
+		{"partition-files",0,POPT_ARG_INT,		NULL,	106,	"Maximum partition files to keep open at once. Defaults to 64.", "files"},
+		{"stats",		 0,	POPT_ARG_STRING,	NULL,	107,	"Print per file row counts, failures and timings to stderr at exit as a table or JSON.", "table|json"},
+		{"stats-prometheus",0,POPT_ARG_STRING,	NULL,	108,	"Write the --stats counters to this file in Prometheus text format.", "file"},
+		{"trace",		 0,	POPT_ARG_STRING,	NULL,	109,	"Write timed spans of the processing pipeline to this file as Chrome trace-event JSON.", "file"},
+		{"progress",	 0,	POPT_ARG_NONE,		NULL,	110,	"Report bytes read of the total input, rows/s, MB/s and an ETA to stderr every 2 seconds.", NULL},
+		{"progress-file",0,	POPT_ARG_STRING,	NULL,	111,	"Replace this file with the progress as one line of JSON every 2 seconds.", "file"},
+		{"checkpoint",	 0,	POPT_ARG_STRING,	NULL,	112,	"Periodically record in this file how far each input has been output, so that an interrupted run can be continued with --resume.", "file"},
+		{"checkpoint-interval",0,POPT_ARG_INT,	NULL,	113,	"Seconds between checkpoints. Defaults to 60.", "seconds"},
+		{"resume",		 0,	POPT_ARG_NONE,		NULL,	114,	"Continue the run recorded in the --checkpoint file, appending to its output (redirect with >>).", NULL},
+		{"temp-dir",	 0,	POPT_ARG_STRING,	NULL,	92,	"Directory for --sort temporary files. Defaults to $TMPDIR or /tmp.", "dir"},
 		{"version",		 0,	POPT_ARG_NONE,		NULL,	100,	"Display version.", NULL},
 		POPT_AUTOHELP
 		POPT_TABLEEND
@@ -101,10 +414,82 @@ int main(int argc, const char** argv) {
 			case 80:
 				strCustom2 = poptGetOptArg(optCon);
 				break;
+			case 90:
+				bSort = true;
+				break;
+			case 91:
+				uiSortMemory = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 92:
+				strTempDir = poptGetOptArg(optCon);
+				break;
+			case 93:
+				bMergeSorted = true;
+				break;
+			case 94:
+				strStart = poptGetOptArg(optCon);
+				break;
+			case 95:
+				strEnd = poptGetOptArg(optCon);
+				break;
+			case 96:
+				bOrdered = true;
+				break;
+			case 97:
+				strBinary = poptGetOptArg(optCon);
+				break;
+			case 98:
+				strIndex = poptGetOptArg(optCon);
+				break;
+			case 99:
+				bDedup = true;
+				break;
 			case 100:
 				version(PACKAGE, VERSION);
 				exit(EXIT_SUCCESS);
 				break;
+			case 101:
+				uiDedupHorizon = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 102:
+				strCompress = poptGetOptArg(optCon);
+				break;
+			case 103:
+				uiCompressThreads = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 104:
+				strOutput = poptGetOptArg(optCon);
+				break;
+			case 105:
+				strPartition = poptGetOptArg(optCon);
+				break;
+			case 106:
+				uiPartitionFiles = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 107:
+				strStats = poptGetOptArg(optCon);
+				break;
+			case 108:
+				strStatsPrometheus = poptGetOptArg(optCon);
+				break;
+			case 109:
+				strTrace = poptGetOptArg(optCon);
+				break;
+			case 110:
+				bProgress = true;
+				break;
+			case 111:
+				strProgressFile = poptGetOptArg(optCon);
+				break;
+			case 112:
+				strCheckpoint = poptGetOptArg(optCon);
+				break;
+			case 113:
+				uiCheckpointInterval = strtoul(poptGetOptArg(optCon), NULL, 10);
+				break;
+			case 114:
+				bResume = true;
+				break;
 		}
 		iOption = poptGetNextOpt(optCon);
 	}
@@ -120,120 +505,478 @@ int main(int argc, const char** argv) {
 		cstrFilename = poptGetArg(optCon);
 	}
 	
+	if (strTrace != "" && !traceOpen(strTrace, strType)) {
+		exit(EXIT_FAILURE);
+	}
+
+	// Per row errors/warnings from here on are written by the limiter's thread
+	logLimiterStart();
+
+	if ((strType == "pix" || strType == "auto-syslog") && strCustom1 != "") {
+		if (!loadPIXPrograms(strCustom1)) {
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (strType == "format") {
+		if (strCustom1 == "") {
+			usage(optCon, "Missing format definition", "--type format requires --custom1 <definition file>");
+			exit(EXIT_FAILURE);
+		} else if (!format.load(strCustom1)) {
+			exit(EXIT_FAILURE);
+		}
+	} else if (strType == "regex") {
+		if (strCustom1 == "") {
+			usage(optCon, "Missing pattern", "--type regex requires --custom1 <pattern> and optionally --custom2 <time layout>");
+			exit(EXIT_FAILURE);
+		} else if (!regex.compile(strCustom1)) {
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (strStart != "" || strEnd != "") {
+		timeStart = (strStart != "" ? getUnix32FromWindowString(strStart, &tzcalc) : 0);
+		timeEnd = (strEnd != "" ? getUnix32FromWindowString(strEnd, &tzcalc) : 0x7fffffff);
+		if (timeStart < 0 || timeEnd < 0 || timeEnd < timeStart) {
+			usage(optCon, "Invalid time window", "--start/--end must be a Unix time, 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS' with --start <= --end");
+			exit(EXIT_FAILURE);
+		}
+		setTimeWindow(timeStart, timeEnd);
+	}
+
+	// Seeking only pays off (and is only safe) with a window, ordered input and a type with a cheap time extractor;
+	// anything else is read linearly through the window filter as usual.
+	rowTimeFunc fnSeekTime = ((bOrdered || bMergeSorted) && (strStart != "" || strEnd != "") ? getRowTimeFunc(strType) : NULL);
+
+	if (bSort && bMergeSorted) {
+		usage(optCon, "Conflicting options", "--sort and --merge-sorted cannot be combined");
+		exit(EXIT_FAILURE);
+	} else if (bSort) {
+		if (uiSortMemory < 1) {
+			usage(optCon, "Invalid sort memory", "--sort-memory must be at least 1 (MB)");
+			exit(EXIT_FAILURE);
+		}
+		pSorter = new bodySorter(strTempDir, uiSortMemory * 1024 * 1024);
+	}
+
+	if (strBinary != "") {
+		if (bSort) {
+			usage(optCon, "Conflicting options", "--sort cannot be combined with --binary (use --merge-sorted for ordered inputs)");
+			exit(EXIT_FAILURE);
+		}
+		if (strIndex != "") {
+			usage(optCon, "Conflicting options", "--index is for the text body output; --binary files carry their own block time ranges");
+			exit(EXIT_FAILURE);
+		}
+		pColumns = new columnWriter();
+		if (!pColumns->open(strBinary)) {
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (strIndex != "") {
+		if (!bSort && !bMergeSorted) {
+			usage(optCon, "Unordered output", "--index requires --sort or --merge-sorted");
+			exit(EXIT_FAILURE);
+		}
+		pIndex = new timeIndex();
+	}
+
+	if (strOutput != "") {
+		if (strOutput.compare(0, 7, "sqlite:") != 0 || strOutput.length() == 7) {
+			usage(optCon, "Unknown output", "--output supports sqlite:<database>");
+			exit(EXIT_FAILURE);
+		} else if (!sqliteWriter::isAvailable()) {
+			usage(optCon, "Unavailable output", "--output sqlite: requires a build with sqlite3");
+			exit(EXIT_FAILURE);
+		} else if (bSort || strBinary != "" || strIndex != "" || strCompress != "") {
+			usage(optCon, "Conflicting options", "--output cannot be combined with --sort, --binary, --index or --compress");
+			exit(EXIT_FAILURE);
+		}
+		pSQLite = new sqliteWriter();
+		if (!pSQLite->open(strOutput.substr(7))) {
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (strPartition != "") {
+		size_t posColon = strPartition.find(':');
+		int iPartition = (posColon != string::npos ? partitionWriter::getPartition(strPartition.substr(0, posColon)) : 0);
+		if (!iPartition || posColon + 1 == strPartition.length()) {
+			usage(optCon, "Invalid partition", "--partition must be hour:<dir>, day:<dir> or log-src:<dir>");
+			exit(EXIT_FAILURE);
+		} else if (bSort || strBinary != "" || strIndex != "" || strCompress != "" || strOutput != "") {
+			usage(optCon, "Conflicting options", "--partition cannot be combined with --sort, --binary, --index, --compress or --output");
+			exit(EXIT_FAILURE);
+		}
+		pPartition = new partitionWriter(iPartition, strPartition.substr(posColon + 1), uiPartitionFiles);
+	}
+
+	if (strCompress != "") {
+		int iCodec = compressedOutput::getCodec(strCompress);
+		if (!iCodec) {
+			usage(optCon, "Unknown compression", "--compress supports gzip (and zstd if built with libzstd)");
+			exit(EXIT_FAILURE);
+		} else if (strBinary != "" || strIndex != "") {
+			usage(optCon, "Conflicting options", "--compress applies to the text body output and cannot be combined with --binary or --index");
+			exit(EXIT_FAILURE);
+		}
+		pCompressed = new compressedOutput(iCodec, uiCompressThreads, stdout);
+		pCoutBuffer = cout.rdbuf(pCompressed);
+	}
+
+	if (strStats != "" || strStatsPrometheus != "") {
+		if (strStats != "" && strStats != "table" && strStats != "json") {
+			usage(optCon, "Invalid stats format", "--stats must be table or json");
+			exit(EXIT_FAILURE);
+		}
+		// auto-syslog counts rows per device class
+		vector<string> vecParsers;
+		if (strType == "auto-syslog") {
+			for (int i=0; i<SYSLOG_CLASS_COUNT; i++) {
+				vecParsers.push_back(getSyslogClassName(i));
+			}
+		} else {
+			vecParsers.push_back(strType);
+		}
+		pStats = new runStats(strType, vecParsers);
+	}
+
+	if (bDedup) {
+		pDedup = new rowDeduplicator(uiDedupHorizon);
+	}
+
+	if (strCheckpoint != "") {
+		if (bSort || bMergeSorted || strBinary != "" || strOutput != "" || strPartition != "" || strCompress != "" || bDedup) {
+			usage(optCon, "Conflicting options", "--checkpoint applies to the plain body output and cannot be combined with --sort, --merge-sorted, --binary, --output, --partition, --compress or --dedup");
+			exit(EXIT_FAILURE);
+		} else if (filenameVector.size() < 1) {
+			usage(optCon, "No input files", "--checkpoint cannot record positions in stdin");
+			exit(EXIT_FAILURE);
+		}
+		pCheckpoint = new checkpoint(strCheckpoint, strType, filenameVector, uiCheckpointInterval);
+		if ((bResume && !pCheckpoint->load()) || !pCheckpoint->prepareOutput(bResume)) {
+			exit(EXIT_FAILURE);
+		}
+	} else if (bResume) {
+		usage(optCon, "Missing checkpoint", "--resume requires --checkpoint");
+		exit(EXIT_FAILURE);
+	}
+
 	if (filenameVector.size() < 1) {
 		filenameVector.push_back("");		//If no files are given, an empty filename will cause libDelimText::textFile to read from stdin
 	}
 
-	for (vector<string>::iterator it = filenameVector.begin(); it != filenameVector.end(); it++) {
-		if (txtFileObj.open(*it)) {
+	if (bProgress || strProgressFile != "") {
+		pProgress = new progressReporter(bProgress, strProgressFile);
+		for (vector<string>::iterator it = filenameVector.begin(); it != filenameVector.end(); it++) {
+			pProgress->addFile(*it);
+		}
+		pProgress->start();
+	}
+
+	processorContext context;
+	context.strType = strType;
+	context.uiYear = uiYear;
+	context.uiSkew = uiSkew;
+	context.bNormalize = bNormalize;
+	context.pTZCalc = &tzcalc;
+	context.pFormat = &format;
+	context.pRegex = &regex;
+	context.strCustom2 = strCustom2;
+	context.puiSyslogCounts = uiSyslogCounts;
+	context.uiParser = 0;
+	context.fnOrderedTime = (strEnd != "" ? fnSeekTime : NULL);
+	context.timeEnd = timeEnd;
+
+	outputContext output;
+	output.pDedup = pDedup;
+	output.pColumns = pColumns;
+	output.pSQLite = pSQLite;
+	output.pPartition = pPartition;
+	output.pSorter = pSorter;
+	output.pIndex = pIndex;
 
-			string strData;
-			string strFields[11];
-			string strSecondary[11];
+	// For these types, we know there is a leading header row and we use that row to figure out what should be read.
+	bool bHeader = (strType == "griffeye" || strType == "ief" || strType == "notes" || strType == "exiftool");
 
-			// For these types, we know there is a leading header row and we use that row to figure out what should be read.
+	if (bMergeSorted) {
+		// Heap entries are (time of the stream's next row, stream); ties go to the earlier file
+		vector<mergeStream> streams(filenameVector.size());
+		priority_queue<pair<u_int32_t, size_t>, vector<pair<u_int32_t, size_t> >, greater<pair<u_int32_t, size_t> > > heap;
+
+		for (size_t i=0; i<filenameVector.size(); i++) {
+			mergeStream& stream = streams[i];
+			stream.pFile = new textFile();
+			stream.pMapped = NULL;
+			stream.strFilename = filenameVector[i];
+			stream.uiLine = 0;
+			stream.uiLastTime = 0;
+			stream.uiOutOfOrder = 0;
+			stream.pStats = pStats;
+			stream.uiStatsFile = (pStats ? pStats->addFile(stream.strFilename) : 0);
+			stream.pProgress = pProgress;
+			bool bOpen = false;
+			{
+				traceSpan span("open", stream.strFilename);
+				if (fnSeekTime && stream.strFilename != "") {
+					stream.pMapped = new mappedFile();
+					if (stream.pMapped->open(stream.strFilename)) {
+						stream.pMapped->seekTime(timeStart, fnSeekTime, uiSkew, &tzcalc);
+					} else {
+						delete stream.pMapped;
+						stream.pMapped = NULL;
+					}
+				}
+				bOpen = (stream.pMapped || stream.pFile->open(stream.strFilename));
+			}
+			if (bOpen) {
+				if (bHeader) {
+					stream.strHeader = stream.pFile->getNextRow();
+					stream.uiLine++;
+				}
+				fillMergeStream(&stream, &context);
+				if (!stream.rows.empty()) {
+					heap.push(make_pair(stream.rows.front().uiTime, i));
+				}
+			} else {
+				LOG_ERROR(stream.strFilename << ": Unable to open file");
+			}
+		}
+
+		traceBeginBatch("(merge)");
+		while (!heap.empty()) {
+			mergeStream& stream = streams[heap.top().second];
+			heap.pop();
+			outputRow(stream.rows.front().strFields, &output);
+			stream.rows.pop_front();
+			fillMergeStream(&stream, &context);
+			if (!stream.rows.empty()) {
+				heap.push(make_pair(stream.rows.front().uiTime, &stream - &streams[0]));
+			}
+		}
+		traceEndBatch();
+
+		for (vector<mergeStream>::iterator it = streams.begin(); it != streams.end(); it++) {
+			if (pProgress) {
+				pProgress->endFile(it - streams.begin());
+			}
+			if (it->uiOutOfOrder) {
+				LOG_WARNING(it->strFilename << ": " << it->uiOutOfOrder << " row(s) out of time order");
+			}
+			delete it->pFile;
+			delete it->pMapped;
+		}
+	} else {
+		for (vector<string>::iterator it = filenameVector.begin(); it != filenameVector.end(); it++) {
+			size_t uiFile = it - filenameVector.begin();
+			if (pCheckpoint && pCheckpoint->isFileDone(uiFile)) {
+				if (pProgress) {
+					pProgress->endFile(uiFile);
+				}
+				continue;
+			}
+
+			size_t uiStatsFile = (pStats ? pStats->addFile(*it) : 0);
+			if (pStats) {
+				pStats->beginFile(uiStatsFile);
+			}
+
+			// --checkpoint reads through mappedFile for its offsets; the header is read before seeking past it
+			mappedFile mapFileObj;
+			bool bMapped = false;
+			bool bOpen = false;
 			string strHeader;
-			if (strType == "griffeye" || strType == "ief" || strType == "notes" || strType == "exiftool") {
-				strHeader = txtFileObj.getNextRow();
-				DEBUG("strHeader: " << strHeader);
-			}	  
-
-			while (txtFileObj.getNextRow(&strData)) {
-				DEBUG("strData: " << strData);
-
-				if (strType == "squidw3c") {
-	 				processSquidW3c(&strData, uiYear, uiSkew, bNormalize, &tzcalc, strFields, strSecondary);
-				} else if (strType == "symantec") {
-	 				processSymantec(&strData, uiYear, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "ipfw") {
-					strFields[MULTI2MAC_LOG] = "--------ipfw";
-					strFields[MULTI2MAC_DETAIL] = "Not Yet Implemented";
-				} else if (strType == "pf") {
-					strFields[MULTI2MAC_LOG] = "----------pf";
-					strFields[MULTI2MAC_DETAIL] = "Not Yet Implemented";
-				} else if (strType == "pix") {
-					processPIX(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "juniper") {
-					processJuniper(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "custfsbt") {
-					processCustomFSBT(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "custfsem") {
-					processCustomFSEM(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "cusvpns1") {
-					processCustomVPN_S1(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "fortg1k5") {
-					processFortiGate1K5(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "hirsch") {
-					processHirsch(&strData, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "griffeye") {
-					processGriffeyeCSV(&strData, &strHeader, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "ief") {
-					processIEF(&strData, &strHeader, &*it, uiSkew, bNormalize, &tzcalc, strFields, strSecondary);
-				} else if (strType == "notes") {
-					processNotes(&strData, &strHeader, uiSkew, bNormalize, &tzcalc, strFields);
-				} else if (strType == "exiftool") {
-					processExifTool(&strData, &strHeader, uiSkew, bNormalize, &tzcalc, strFields, strSecondary);
-				} else {
-					strFields[MULTI2MAC_LOG] = "-----unknown";
-					strFields[MULTI2MAC_DETAIL] = "Unknown Type";
+			{
+				traceSpan span("open", *it);
+				bMapped = ((fnSeekTime || pCheckpoint) && *it != "" && mapFileObj.open(*it));
+				bOpen = (bMapped || (!pCheckpoint && txtFileObj.open(*it)));
+				if (bOpen && bHeader) {
+					if (bMapped) {
+						mapFileObj.getNextRow(&strHeader);
+					} else {
+						strHeader = txtFileObj.getNextRow();
+					}
+					DEBUG("strHeader: " << strHeader);
+				}
+				if (pCheckpoint && pCheckpoint->getFileOffset(uiFile)) {
+					mapFileObj.seekOffset(pCheckpoint->getFileOffset(uiFile));
+				} else if (bMapped && fnSeekTime) {
+					mapFileObj.seekTime(timeStart, fnSeekTime, uiSkew, &tzcalc);
 				}
+			}
 
-				if (strFields[MULTI2MAC_DETAIL].length() > 0 ) {
-					// Do some rudimentary cleanup on the data; since '|' is a field delimiter, it cannot be in the final output.
-					replace(strFields[MULTI2MAC_HASH].begin(), strFields[MULTI2MAC_HASH].end(), '|', '-');
-					replace(strFields[MULTI2MAC_DETAIL].begin(), strFields[MULTI2MAC_DETAIL].end(), '|', '-');
-					replace(strFields[MULTI2MAC_TYPE].begin(), strFields[MULTI2MAC_TYPE].end(), '|', '-');
-					replace(strFields[MULTI2MAC_LOG].begin(), strFields[MULTI2MAC_LOG].end(), '|', '-');
-					replace(strFields[MULTI2MAC_FROM].begin(), strFields[MULTI2MAC_FROM].end(), '|', '-');
-					replace(strFields[MULTI2MAC_TO].begin(), strFields[MULTI2MAC_TO].end(), '|', '-');
-	
-					// Output final mactime format
-					cout 					<< strFields[MULTI2MAC_HASH]		<< "|"
-											<< strFields[MULTI2MAC_DETAIL]	<< "|"
-											<< strFields[MULTI2MAC_TYPE]		<< "|"
-											<< strFields[MULTI2MAC_LOG]		<< "|"
-											<< strFields[MULTI2MAC_FROM]		<< "|"
-											<< strFields[MULTI2MAC_TO]			<< "|"
-											<< strFields[MULTI2MAC_SIZE]		<< "|"
-											<< strFields[MULTI2MAC_ATIME]		<< "|"
-											<< strFields[MULTI2MAC_MTIME]		<< "|"
-											<< strFields[MULTI2MAC_CTIME]		<< "|"
-											<< strFields[MULTI2MAC_BTIME]		<< "\n";
-				} // if (strFields[MULTI2MAC_DETAIL].length() > 0 ) {
-	
-				// If secondary records created, output them in mactime format also
-				if (strSecondary[MULTI2MAC_DETAIL].length() > 0) {
-					// Do some rudimentary cleanup on the data; since '|' is a field delimiter, it cannot be in the final output.
-					replace(strSecondary[MULTI2MAC_HASH].begin(), strSecondary[MULTI2MAC_HASH].end(), '|', '-');
-					replace(strSecondary[MULTI2MAC_DETAIL].begin(), strSecondary[MULTI2MAC_DETAIL].end(), '|', '-');
-					replace(strSecondary[MULTI2MAC_TYPE].begin(), strSecondary[MULTI2MAC_TYPE].end(), '|', '-');
-					replace(strSecondary[MULTI2MAC_LOG].begin(), strSecondary[MULTI2MAC_LOG].end(), '|', '-');
-					replace(strSecondary[MULTI2MAC_FROM].begin(), strSecondary[MULTI2MAC_FROM].end(), '|', '-');
-					replace(strSecondary[MULTI2MAC_TO].begin(), strSecondary[MULTI2MAC_TO].end(), '|', '-');
+			if (bOpen) {
+
+				string strData;
+				string strFields[11];
+				string strSecondary[11];
+
+				traceBeginBatch(*it);
+				while (bMapped ? mapFileObj.getNextRow(&strData) : txtFileObj.getNextRow(&strData)) {
+					u_int64_t uiTimeFailures = getTimeFailures();
+					{
+						traceStage stage(SPANTRACER_STAGE_PARSE);
+						processRow(&context, &strData, &strHeader, &*it, strFields, strSecondary);
+					}
+					if (pStats) {
+						pStats->addRow(uiStatsFile, context.uiParser, strData.length() + 1, strFields[MULTI2MAC_DETAIL].length() == 0, getTimeFailures() - uiTimeFailures);
+					}
+					if (pProgress) {
+						pProgress->addRow(strData.length() + 1);
+					}
+					if (pastTimeWindow(&context, &strData, strFields)) {
+						break;
+					}
+
+					if (strFields[MULTI2MAC_DETAIL].length() > 0 && rowInTimeWindow(strFields)) {
+						outputRow(strFields, &output);
+						if (pStats) {
+							pStats->addEmitted(uiStatsFile, context.uiParser, false);
+						}
+					}
 	
-					cout 				<< strSecondary[MULTI2MAC_HASH]		<< "|"
-										<< strSecondary[MULTI2MAC_DETAIL]	<< "|"
-										<< strSecondary[MULTI2MAC_TYPE]		<< "|"
-										<< strSecondary[MULTI2MAC_LOG]		<< "|"
-										<< strSecondary[MULTI2MAC_FROM]		<< "|"
-										<< strSecondary[MULTI2MAC_TO]			<< "|"
-										<< strSecondary[MULTI2MAC_SIZE]		<< "|"
-										<< strSecondary[MULTI2MAC_ATIME]		<< "|"
-										<< strSecondary[MULTI2MAC_MTIME]		<< "|"
-										<< strSecondary[MULTI2MAC_CTIME]		<< "|"
-										<< strSecondary[MULTI2MAC_BTIME]		<< "\n";
-				} // if (strSecondary[MULTI2MAC_DETAIL].length() > 0) {
-
-				// Clear out values for the next line
-				for (int i=0; i<11; i++) {
-					strFields[i] = "";
-					strSecondary[i] = "";
+					// If secondary records created, output them in mactime format also
+					if (strSecondary[MULTI2MAC_DETAIL].length() > 0 && rowInTimeWindow(strSecondary)) {
+						outputRow(strSecondary, &output);
+						if (pStats) {
+							pStats->addEmitted(uiStatsFile, context.uiParser, true);
+						}
+					}
+
+					// Clear out values for the next line
+					for (int i=0; i<11; i++) {
+						strFields[i] = "";
+						strSecondary[i] = "";
+					}
+
+					if (pCheckpoint && pCheckpoint->isDue()) {
+						cout.flush();
+						if (!pCheckpoint->save(uiFile, mapFileObj.getOffset(), false)) {
+							exit(EXIT_FAILURE);
+						}
+					}
+					traceEndRow();
+				}
+				traceEndBatch();
+			} else if (pCheckpoint) {
+				// Stop rather than record the file as done; the checkpoint still holds the files before it, so the run can
+				// be resumed once the file is readable
+				LOG_ERROR(*it << ": Unable to open file (--checkpoint reads regular files only); resume with --resume once it can be read");
+				exit(EXIT_FAILURE);
+			} else {
+				LOG_ERROR(*it << ": Unable to open file");
+			} // if (txtFileObj.open(*it)) { 
+
+			if (pStats) {
+				pStats->endFile(uiStatsFile);
+			}
+			if (pProgress) {
+				pProgress->endFile(uiFile);
+			}
+			// The file was opened and read to its end (or to --end in an --ordered input)
+			if (pCheckpoint) {
+				cout.flush();
+				if (!pCheckpoint->save(uiFile, 0, true)) {
+					exit(EXIT_FAILURE);
 				}
 			}
-		} else {
-			ERROR(*it << ": Unable to open file");
-		} // if (txtFileObj.open(*it)) { 
-	}	// for (vector<string>::iterator it = arguments.filenameVector.begin(); it != arguments.filenameVector.end(); it++) {
+		}	// for (vector<string>::iterator it = arguments.filenameVector.begin(); it != arguments.filenameVector.end(); it++) {
+	}
+
+	if (pColumns) {
+		traceSpan span("close binary");
+		if (!pColumns->close()) {
+			exit(EXIT_FAILURE);
+		}
+		delete pColumns;
+	}
+
+	if (pPartition) {
+		traceSpan span("close partitions");
+		if (!pPartition->close()) {
+			exit(EXIT_FAILURE);
+		}
+		delete pPartition;
+	}
+
+	if (pSQLite) {
+		traceSpan span("close database");
+		if (!pSQLite->close()) {
+			exit(EXIT_FAILURE);
+		}
+		delete pSQLite;
+	}
+
+	if (pSorter) {
+		traceSpan span("sort output");
+		cout.flush();
+		if (!pSorter->finish(&cout, pIndex)) {
+			exit(EXIT_FAILURE);
+		}
+		delete pSorter;
+	}
+
+	{
+		traceSpan span("flush");
+		cout.flush();
+	}
+
+	if (pCompressed) {
+		traceSpan span("close compressed");
+		cout.rdbuf(pCoutBuffer);
+		if (!pCompressed->close()) {
+			exit(EXIT_FAILURE);
+		}
+		delete pCompressed;
+	}
+
+	if (pProgress) {
+		pProgress->stop();
+		delete pProgress;
+	}
+	// The summaries below write to stderr directly; with the progress and limiter threads gone nothing else does
+	logLimiterStop();
+
+	if (pCheckpoint) {
+		delete pCheckpoint;
+	}
+
+	if (pIndex) {
+		if (!pIndex->write(strIndex)) {
+			exit(EXIT_FAILURE);
+		}
+		delete pIndex;
+	}
+
+	if (pDedup) {
+		cerr << "dedup: " << pDedup->getDuplicates() << " duplicate row(s) dropped\n";
+		delete pDedup;
+	}
+
+	if (pStats) {
+		if (strStats == "table") {
+			pStats->printTable(&cerr);
+		} else if (strStats == "json") {
+			pStats->printJSON(&cerr);
+		}
+		if (strStatsPrometheus != "" && !pStats->writePrometheus(strStatsPrometheus)) {
+			exit(EXIT_FAILURE);
+		}
+		delete pStats;
+	}
+
+	if (strType == "auto-syslog") {
+		cerr << "auto-syslog:";
+		for (int i=0; i<SYSLOG_CLASS_COUNT; i++) {
+			cerr << " " << getSyslogClassName(i) << "=" << uiSyslogCounts[i];
+		}
+		cerr << "\n";
+	}
+
+	if (strTrace != "" && !traceClose()) {
+		exit(EXIT_FAILURE);
+	}
 
 	if (strLog != "") {
 		logClose();
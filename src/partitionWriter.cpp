@@ -0,0 +1,135 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "partitionWriter.h"
+#include "processor.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <cstdio>
+#include <cctype>
+#include <ctime>
+using namespace std;
+
+#define PARTITIONWRITER_IO_BUFFER	(64 * 1024)
+
+partitionWriter::partitionWriter(int iPartition, string strDirectory, size_t uiMaxFiles) : m_iPartition(iPartition), m_strDirectory(strDirectory), m_uiMaxFiles(uiMaxFiles ? uiMaxFiles : 1), m_bFailed(false) {
+}
+
+partitionWriter::~partitionWriter() {
+	close();
+}
+
+// Returns 0 for an unknown partition name.
+int partitionWriter::getPartition(string strName) {
+	if (strName == "hour") {
+		return PARTITIONWRITER_HOUR;
+	} else if (strName == "day") {
+		return PARTITIONWRITER_DAY;
+	} else if (strName == "log-src") {
+		return PARTITIONWRITER_LOG_SRC;
+	}
+	return 0;
+}
+
+string partitionWriter::getPartitionName(const string* strFields) const {
+	if (m_iPartition == PARTITIONWRITER_LOG_SRC) {
+		string strLog = strFields[MULTI2MAC_LOG];
+		strLog.erase(0, strLog.find_first_not_of('-'));
+		if (strLog.empty()) {
+			return "unknown";
+		}
+		for (string::iterator it = strLog.begin(); it != strLog.end(); it++) {
+			if (!isalnum((unsigned char)*it) && *it != '.' && *it != '_' && *it != '-') {
+				*it = '_';
+			}
+		}
+		return strLog;
+	}
+
+	time_t uiTime = getBodyRowTime(strFields);
+	if (!uiTime) {
+		return "untimed";
+	}
+	struct tm tmTime;
+	gmtime_r(&uiTime, &tmTime);
+	char cstrName[32];
+	strftime(cstrName, sizeof(cstrName), (m_iPartition == PARTITIONWRITER_HOUR ? "%Y-%m-%dT%H" : "%Y-%m-%d"), &tmTime);
+	return cstrName;
+}
+
+FILE* partitionWriter::getFile(const string& strName) {
+	map<string, partitionFile>::iterator it = m_mapOpen.find(strName);
+	if (it != m_mapOpen.end()) {
+		m_listLRU.splice(m_listLRU.begin(), m_listLRU, it->second.itLRU);
+		return it->second.pFile;
+	}
+
+	// Evicting flushes the file's buffered rows; a failure there loses them, so it fails the writer
+	if (m_mapOpen.size() >= m_uiMaxFiles && !closeFile(m_mapOpen.find(m_listLRU.back()))) {
+		m_bFailed = true;
+		return NULL;
+	}
+
+	string strFilename = m_strDirectory + "/" + strName + ".body";
+	bool bCreated = m_setCreated.insert(strName).second;
+	FILE* pFile = fopen(strFilename.c_str(), (bCreated ? "w" : "a"));
+	if (!pFile) {
+		LOG_ERROR("partitionWriter::getFile() Unable to open " << strFilename);
+		return NULL;
+	}
+	setvbuf(pFile, NULL, _IOFBF, PARTITIONWRITER_IO_BUFFER);
+	DEBUG("partitionWriter::getFile() Opened " << strFilename << " (" << m_mapOpen.size() + 1 << " open)");
+
+	m_listLRU.push_front(strName);
+	partitionFile partition = { pFile, m_listLRU.begin() };
+	m_mapOpen[strName] = partition;
+	return pFile;
+}
+
+bool partitionWriter::closeFile(map<string, partitionFile>::iterator it) {
+	bool rv = (fclose(it->second.pFile) == 0);
+	if (!rv) {
+		LOG_ERROR("partitionWriter::closeFile() Unable to write " << m_strDirectory << "/" << it->first << ".body");
+	}
+	m_listLRU.erase(it->second.itLRU);
+	m_mapOpen.erase(it);
+	return rv;
+}
+
+bool partitionWriter::add(string* strFields) {
+	if (m_bFailed) {
+		return false;
+	}
+
+	FILE* pFile = getFile(getPartitionName(strFields));
+	formatBodyRow(strFields, &m_strRow);
+	if (!pFile || fwrite(m_strRow.data(), 1, m_strRow.length(), pFile) != m_strRow.length()) {
+		m_bFailed = true;
+	}
+	return !m_bFailed;
+}
+
+bool partitionWriter::close() {
+	while (!m_mapOpen.empty()) {
+		if (!closeFile(m_mapOpen.begin())) {
+			m_bFailed = true;
+		}
+	}
+	return !m_bFailed;
+}
@@ -0,0 +1,75 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_PARTITIONWRITER_H_
+#define MULTI2MACTIME_PARTITIONWRITER_H_
+
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+#include <cstdio>
+using namespace std;
+
+// Splits the body output into one file per partition (--partition) in a directory:
+//
+//	hour		YYYY-MM-DDTHH.body (UTC, from getBodyRowTime())
+//	day		YYYY-MM-DD.body
+//	log-src	<LOG-SRC>.body, with leading '-' padding removed and anything but [A-Za-z0-9._-] replaced by '_'
+//
+// Rows without a time go to untimed.body (hour/day) and rows without a LOG-SRC to unknown.body. Each open partition
+// has its own buffered FILE; when more than the handle limit are open, the least recently written one is closed and
+// is reopened for appending if more rows arrive. Partition files are truncated the first time they are opened in a run.
+
+#define PARTITIONWRITER_HOUR				1
+#define PARTITIONWRITER_DAY				2
+#define PARTITIONWRITER_LOG_SRC			3
+
+#define PARTITIONWRITER_DEFAULT_FILES	64
+
+class partitionWriter {
+	public:
+		partitionWriter(int iPartition, string strDirectory, size_t uiMaxFiles = PARTITIONWRITER_DEFAULT_FILES);
+		~partitionWriter();
+
+		bool add(string* strFields);
+		bool close();
+
+		static int getPartition(string strName);
+
+	private:
+		struct partitionFile {
+			FILE* pFile;
+			list<string>::iterator itLRU;
+		};
+
+		partitionWriter(const partitionWriter&);
+		partitionWriter& operator=(const partitionWriter&);
+
+		string getPartitionName(const string* strFields) const;
+		FILE* getFile(const string& strName);
+		bool closeFile(map<string, partitionFile>::iterator it);
+
+		int m_iPartition;
+		string m_strDirectory;
+		size_t m_uiMaxFiles;
+		bool m_bFailed;
+
+		map<string, partitionFile> m_mapOpen;
+		list<string> m_listLRU;					// most recently written first
+		set<string> m_setCreated;
+		string m_strRow;
+};
+
+#endif /*MULTI2MACTIME_PARTITIONWRITER_H_*/
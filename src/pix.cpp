@@ -17,114 +17,302 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
+#include "textSearch.h"
+#include "syslog.h"
 
 #include <string>
+#include <vector>
+#include <map>
+#include <cctype>
 using namespace std;
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
 #include "libtimeUtils/src/timeUtils.h"
+#include "libdelimText/src/textFile.h"
 #include "libdelimText/src/textUtils.h"
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
-void processPIX(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
-	int32_t timeVal = -1;
-	int32_t uiPIXPos = pstrData->find("%PIX", 16);
-	if (uiPIXPos > 0) {
-		string strTime = string(*pstrData, uiPIXPos - 22, 20);  //Find "%PIX" and then backup 22 characters to get the PIX generated time, not the receiving syslog time
-		if (strTime.length()) {
-			  	  boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
-				  if (pTZCalc->createLocalTime(strTime, "%b %d %Y %H:%M:%S", &ldt)) {
-						timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
-				  } else {
-						ERROR("processPIX() Unable to createLocalTime()");
-				  }
+// Each PIX/ASA message code has its own layout, so the fields worth saving (src, dst, etc.) are described by a small
+// per-code extraction program instead of a hard-coded switch. A program is a list of steps run left-to-right over the
+// message body with a single cursor that only ever moves forward, so the line is never rescanned for each field.
+//
+// Program syntax (whitespace separated steps):
+//		>"text"			Skip forward past the next occurrence of "text"; the program stops if it is not found.
+//		field@"text"	Capture from the cursor up to "text" (or end of line) and skip past it.
+//		field@[chars]	Capture from the cursor up to any one of the given characters (or end of line) and skip past it.
+//		field@""			Capture the remainder of the line.
+//
+// Fields: src, sport, dst, dport, bytes, sent, rcvd, service
+//
+// Additional programs (or replacements for the built-in ones) can be loaded at startup from a file containing
+// "<code> <program>" lines; blank lines and lines starting with '#' are ignored.
+
+#define PIX_STEP_SKIP		1
+#define PIX_STEP_CAPTURE	2
+#define PIX_STEP_CAPTURE_ANY	3
+
+#define PIX_FIELD_SRC		0
+#define PIX_FIELD_SPORT		1
+#define PIX_FIELD_DST		2
+#define PIX_FIELD_DPORT		3
+#define PIX_FIELD_BYTES		4
+#define PIX_FIELD_SENT		5
+#define PIX_FIELD_RCVD		6
+#define PIX_FIELD_SERVICE	7
+#define PIX_FIELD_COUNT		8
+
+static const char* PIX_FIELD_NAMES[PIX_FIELD_COUNT] = { "src", "sport", "dst", "dport", "bytes", "sent", "rcvd", "service" };
+
+struct pixStep {
+	int iOp;
+	int iField;
+	string strText;
+};
+
+static const struct {
+	u_int32_t uiCode;
+	const char* cstrProgram;
+} PIX_PROGRAMS[] = {
+	// Deny TCP (no connection) from 10.1.1.1/1234 to 10.2.2.2/80 flags RST on interface inside
+	{106001,	">\" from \" src@[/] sport@[ ] >\"to \" dst@[/] dport@[ ]"},
+	{106006,	">\" from \" src@[/] sport@[ ] >\"to \" dst@[/] dport@[ ]"},
+	{106007,	">\" from \" src@[/] sport@[ ] >\"to \" dst@[/] dport@[ ]"},
+	{106015,	">\" from \" src@[/] sport@[ ] >\"to \" dst@[/] dport@[ ]"},
+	// Deny inbound icmp src outside:10.1.1.1 dst inside:10.2.2.2 (type 8, code 0)
+	{106014,	">\" src \" >\":\" src@[ ] >\"dst \" >\":\" dst@[ ]"},
+	// Deny tcp src outside:10.1.1.1/1234 dst inside:10.2.2.2/80 by access-group "acl"
+	{106023,	">\" src \" >\":\" src@[/] sport@[ ] >\"dst \" >\":\" dst@[/] dport@[ ]"},
+	{305005,	">\" src \" >\":\" src@[/] sport@[ ] >\"dst \" >\":\" dst@[/] dport@[ ]"},
+	{305006,	">\" src \" >\":\" src@[/ ] >\"dst \" >\":\" dst@[/ ]"},
+	// access-list acl permitted tcp inside/10.1.1.1(1234) -> outside/10.2.2.2(80) hit-cnt 1 first hit
+	{106100,	">\"/\" src@[(] sport@[)] >\"/\" dst@[(] dport@[)]"},
+	// Denied ICMP type=8, code=0 from 10.1.1.1 on interface outside
+	{313001,	">\" from \" src@[ ]"},
+	// TCP access denied by ACL from 10.1.1.1/1234 to outside:10.2.2.2/22
+	{710003,	">\" from \" src@[/] sport@[ ] >\"to \" >\":\" dst@[/] dport@[ ]"},
+	// Built inbound TCP connection 123 for outside:10.1.1.1/80 (10.1.1.1/80) to inside:10.2.2.2/1234 (10.2.2.2/1234)
+	{302013,	">\" for \" >\":\" src@[/] sport@[ ] >\" to \" >\":\" dst@[/] dport@[ ]"},
+	{302015,	">\" for \" >\":\" src@[/] sport@[ ] >\" to \" >\":\" dst@[/] dport@[ ]"},
+	// Teardown TCP connection 123 for outside:10.1.1.1/80 to inside:10.2.2.2/1234 duration 0:00:05 bytes 1234 TCP FINs
+	{302014,	">\" for \" >\":\" src@[/] sport@[ ] >\"to \" >\":\" dst@[/] dport@[ ] >\" bytes \" bytes@[ ]"},
+	{302016,	">\" for \" >\":\" src@[/] sport@[ ] >\"to \" >\":\" dst@[/] dport@[ ] >\" bytes \" bytes@[ ]"},
+	// Built inbound ICMP connection for faddr 10.1.1.1/0 gaddr 10.2.2.2/0 laddr 10.2.2.2/0
+	{302020,	">\"faddr \" src@[/ ] >\"laddr \" dst@[/ ]"},
+	{302021,	">\"faddr \" src@[/ ] >\"laddr \" dst@[/ ]"},
+	// Built dynamic translation from inside:10.1.1.1 to outside:10.2.2.2
+	{305009,	">\" from \" >\":\" src@[/ ] >\"to \" >\":\" dst@[/ ]"},
+	{305010,	">\" from \" >\":\" src@[/ ] >\"to \" >\":\" dst@[/ ]"},
+	// Built dynamic TCP translation from inside:10.1.1.1/1234 to outside:10.2.2.2/5678
+	{305011,	">\" from \" >\":\" src@[/] sport@[ ] >\"to \" >\":\" dst@[/] dport@[ ]"},
+	{305012,	">\" from \" >\":\" src@[/] sport@[ ] >\"to \" >\":\" dst@[/] dport@[ ]"},
+	// 10.1.1.1 Accessed URL 10.2.2.2:/index.html
+	{304001,	"src@[( ] >\"Accessed URL \" dst@[:]"},
+	// 10.1.1.1 Retrieved 10.2.2.2:file
+	{303002,	"src@[ ] >\"Retrieved \" dst@[:]"},
+	// Built local-host inside:10.1.1.1
+	{609001,	">\" local-host \" >\":\" src@[ ]"},
+	{609002,	">\" local-host \" >\":\" src@[ ]"},
+	// SMTP replaced string: out 10.2.2.2 in 10.1.1.1 data: ...
+	{108002,	">\": out \" dst@\" in \" src@\" data:\""},
+	// Group = G, Username = u, IP = 10.1.1.1, Session disconnected. Session Type: ..., Bytes xmt: 123, Bytes rcv: 456, Reason: ...
+	{113019,	">\"IP = \" src@[,] >\"Bytes xmt: \" sent@[,] >\"Bytes rcv: \" rcvd@[,]"},
+};
+
+static map<u_int32_t, vector<pixStep> > mapPIXPrograms;
+
+static bool compilePIXProgram(string strProgram, vector<pixStep>* pSteps) {
+	bool rv = true;
+	pSteps->clear();
+
+	size_t pos = 0;
+	while (rv && (pos = strProgram.find_first_not_of(" \t", pos)) != string::npos) {
+		pixStep step;
+		step.iOp = 0;
+		step.iField = -1;
+
+		if (strProgram[pos] == '>') {
+			step.iOp = PIX_STEP_SKIP;
+			pos++;
+		} else {
+			size_t posAt = strProgram.find('@', pos);
+			if (posAt != string::npos) {
+				string strField = strProgram.substr(pos, posAt - pos);
+				for (int i=0; i<PIX_FIELD_COUNT; i++) {
+					if (strField == PIX_FIELD_NAMES[i]) {
+						step.iField = i;
+					}
+				}
+				pos = posAt + 1;
+			}
+			if (step.iField < 0) {
+				LOG_ERROR("compilePIXProgram() Unknown field in program (" << strProgram << ")");
+				rv = false;
+				break;
+			}
+		}
+
+		char chClose = (pos < strProgram.length() ? (strProgram[pos] == '"' ? '"' : (strProgram[pos] == '[' ? ']' : 0)) : 0);
+		size_t posClose = (chClose ? strProgram.find(chClose, pos + 1) : string::npos);
+		if (posClose != string::npos) {
+			if (step.iOp != PIX_STEP_SKIP) {
+				step.iOp = (chClose == ']' ? PIX_STEP_CAPTURE_ANY : PIX_STEP_CAPTURE);
+			}
+			step.strText = strProgram.substr(pos + 1, posClose - pos - 1);
+			pSteps->push_back(step);
+			pos = posClose + 1;
+		} else {
+			LOG_ERROR("compilePIXProgram() Unterminated or missing text in program (" << strProgram << ")");
+			rv = false;
 		}
 	}
-	
-	string strMsg = findSubString(findSubString(*pstrData, 16, ": ", ""), 0, ": ", "");
-	string strMsgType = findSubString(*pstrData, 16, ": ", ": ");
-	string strCode = findSubString(findSubString(strMsgType, 0, "%PIX-", ""), 0, "-", "");
-	string strService;
-	string strSrc;
-	string strDst;
-	string strBytes;
-	
-	if (strCode.length()) {
-		u_int32_t uiCode = boost_lexical_cast_wrapper<u_int32_t>(strCode);	//Extract and convert the PIX message code
-		
-		//ODOT	I should come up with a way to define a .conf file for each type of log file to be able to dynamically configure
-		//			which pieces of each entry get saved as src, dest, etc.
-		//NOTE	I was originally truncating strMsg at 25 characters.  That would have meant that searching for an IP address might
-		//			miss data if that IP was in the truncated portion and a specific parser for the event type was not found below.
-		//			Since I am no longer truncating the message, searching for an IP address will always find it in the message even
-		//			if it is not specifically parsed below.
-		
-		switch (uiCode) {
-			case 106015:
-				strSrc = findSubString(*pstrData, 16, " from ", "/");
-				strDst = findSubString(*pstrData, 16, " to ", "/");
-				break;
 
-			case 302010:
-				break;
+	return rv;
+}
 
-			case 305009:
-			case 305010:
-				strSrc = findSubString(findSubString(*pstrData, 16, " from ", " to "), 0, ":", "/");
-				strDst = findSubString(findSubString(*pstrData, 16, " to ", ""), 0, ":", "/");
-				break;
+static void initPIXPrograms() {
+	if (mapPIXPrograms.empty()) {
+		for (size_t i=0; i<sizeof(PIX_PROGRAMS)/sizeof(PIX_PROGRAMS[0]); i++) {
+			compilePIXProgram(PIX_PROGRAMS[i].cstrProgram, &mapPIXPrograms[PIX_PROGRAMS[i].uiCode]);
+		}
+	}
+}
 
-			case 302013:
-			case 302014:
-			case 302015:
-			case 302016:
-				strSrc = findSubString(findSubString(*pstrData, 16, " for ", " to "), 0, ":", "/");
-				strDst = findSubString(findSubString(*pstrData, 16, " to ", ""), 0, ":", "/");
-				break;
+bool loadPIXPrograms(string strFilename) {
+	bool rv = false;
+	initPIXPrograms();
 
-			case 304001:
-				strSrc = findSubString(findSubString(*pstrData, 16, "%PIX", ""), 0, ": ", " Accessed URL ");
-				strDst = findSubString(*pstrData, 16, "Accessed URL ", ":");
-				break;
+	textFile txtFileObj;
+	if (txtFileObj.open(strFilename)) {
+		rv = true;
+		string strLine;
+		while (txtFileObj.getNextRow(&strLine)) {
+			size_t pos = strLine.find_first_not_of(" \t");
+			if (pos != string::npos && strLine[pos] != '#') {
+				size_t posProgram = strLine.find_first_of(" \t", pos);
+				u_int32_t uiCode = boost_lexical_cast_wrapper<u_int32_t>(strLine.substr(pos, posProgram - pos));
+				vector<pixStep> steps;
+				if (uiCode > 0 && posProgram != string::npos && compilePIXProgram(strLine.substr(posProgram), &steps)) {
+					mapPIXPrograms[uiCode] = steps;
+				} else {
+					LOG_ERROR("loadPIXPrograms() Invalid program definition (" << strLine << ")");
+					rv = false;
+				}
+			}
+		}
+	} else {
+		LOG_ERROR("loadPIXPrograms() Unable to open file (" << strFilename << ")");
+	}
 
-			case 106023:
-			case 305005:
-			case 305006:
-				strSrc = findSubString(findSubString(*pstrData, 16, " src ", " dst "), 0, ":", "/");
-				strDst = findSubString(findSubString(*pstrData, 16, " dst ", ""), 0, ":", "/");
-				break;
+	return rv;
+}
 
-			case 609001:
-			case 609002:
-				strSrc = findSubString(findSubString(*pstrData, 16, " local-host ", ""), 0, ":", " ");
-				break;
-				
-			case 303002:
-				strSrc = findSubString(*pstrData, 16, "303002:  ", " Retrieved");
-				strDst = findSubString(*pstrData, 16, " Retrieved ", ":");
-				break;
-				
-			case 108002:
-				strSrc = findSubString(*pstrData, 16, " in ", " data:");
-				strDst = findSubString(*pstrData, 16, ": out ", " in ");
-				break;
+static void runPIXProgram(const vector<pixStep>* pSteps, const string* pstrData, size_t pos, string* strValues) {
+	for (vector<pixStep>::const_iterator it = pSteps->begin(); it != pSteps->end() && pos <= pstrData->length(); it++) {
+		size_t posEnd = (it->iOp == PIX_STEP_CAPTURE_ANY ? pstrData->find_first_of(it->strText, pos) : (it->strText.length() ? findText(pstrData->data(), pstrData->length(), pos, it->strText.data(), it->strText.length()) : string::npos));
+		size_t lenDelim = (it->iOp == PIX_STEP_CAPTURE_ANY ? 1 : it->strText.length());
 
-			default:
+		if (it->iOp == PIX_STEP_SKIP) {
+			if (posEnd == string::npos) {
 				break;
+			}
+		} else {
+			if (posEnd == string::npos) {
+				posEnd = pstrData->length();
+			}
+			strValues[it->iField] = pstrData->substr(pos, posEnd - pos);
+		}
+		pos = posEnd + lenDelim;
+	}
+}
+
+void processPIX(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader) {
+	initPIXPrograms();
+
+	// The device tag is "%PIX-<level>-<code>" (or newer "%ASA-<level>-<code>"); everything after it is the message body.
+	syslogHeader header;
+	if (pHeader != NULL) {
+		header = *pHeader;
+	} else {
+		decodeSyslogHeader(pstrData, &header);
+	}
+
+	int32_t timeVal = -1;
+	size_t posTag = header.spanTag.pos;
+	size_t posBody = header.posBody;
+	if (!header.spanTag.len || (pstrData->compare(posTag, 5, "%PIX-") != 0 && pstrData->compare(posTag, 5, "%ASA-") != 0)) {
+		// Not a recognizable syslog header; look for the device tag in what remains.
+		posTag = pstrData->find('%', header.posBody);
+		while (posTag != string::npos && pstrData->compare(posTag, 5, "%PIX-") != 0 && pstrData->compare(posTag, 5, "%ASA-") != 0) {
+			posTag = pstrData->find('%', posTag + 1);
 		}
+		posBody = (posTag != string::npos ? findText(pstrData, posTag, ": ") : string::npos);
+		header.spanTag.pos = posTag;
+		header.spanTag.len = (posBody != string::npos ? posBody : pstrData->length()) - posTag;
+		posBody = (posBody != string::npos ? posBody + 2 : string::npos);
 	}
-		
+
+	string strMsg;
+	string strMsgType;
+	string strValues[PIX_FIELD_COUNT];
+
+	if (posTag != string::npos) {
+		// Use the PIX generated time, not the receiving syslog time
+		if (header.spanDeviceTime.len) {
+			traceStage stage(SPANTRACER_STAGE_TIME);
+			boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
+			if (pTZCalc->createLocalTime(getSpanString(pstrData, header.spanDeviceTime), "%b %d %Y %H:%M:%S", &ldt)) {
+				timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
+			} else {
+				countTimeFailure();
+				ROW_ERROR("processPIX() Unable to createLocalTime()", "");
+			}
+		}
+		if (!inTimeWindow(timeVal)) {
+			return;
+		}
+
+		strMsgType = getSpanString(pstrData, header.spanTag);
+		posBody = (posBody != string::npos ? pstrData->find_first_not_of(' ', posBody) : string::npos);
+		if (posBody != string::npos) {
+			strMsg = pstrData->substr(posBody);
+
+			// Extract and convert the message code (the digits following the second '-' of the tag)
+			u_int32_t uiCode = 0;
+			size_t posCode = strMsgType.find('-', 5);
+			for (size_t i = (posCode != string::npos ? posCode + 1 : strMsgType.length()); i < strMsgType.length() && isdigit(strMsgType[i]); i++) {
+				uiCode = uiCode * 10 + (strMsgType[i] - '0');
+			}
+
+			//NOTE	I was originally truncating strMsg at 25 characters.  That would have meant that searching for an IP address might
+			//			miss data if that IP was in the truncated portion and a specific parser for the event type was not found below.
+			//			Since I am no longer truncating the message, searching for an IP address will always find it in the message even
+			//			if it is not specifically parsed below.
+			map<u_int32_t, vector<pixStep> >::const_iterator itProgram = mapPIXPrograms.find(uiCode);
+			if (itProgram != mapPIXPrograms.end()) {
+				runPIXProgram(&itProgram->second, pstrData, posBody, strValues);
+			}
+		}
+	}
+
+	string strSrc = strValues[PIX_FIELD_SRC] + (strValues[PIX_FIELD_SPORT].length() ? ":" + strValues[PIX_FIELD_SPORT] : "");
+	string strDst = strValues[PIX_FIELD_DST] + (strValues[PIX_FIELD_DPORT].length() ? ":" + strValues[PIX_FIELD_DPORT] : "");
+	string strBytes = strValues[PIX_FIELD_BYTES];
+	if (strBytes.empty() && (strValues[PIX_FIELD_SENT].length() || strValues[PIX_FIELD_RCVD].length())) {
+		strBytes = strValues[PIX_FIELD_SENT] + "/" + strValues[PIX_FIELD_RCVD];
+	}
+
 	//Output Values
 	strFields[MULTI2MAC_DETAIL]	= strMsg;
-	strFields[MULTI2MAC_TYPE]		= strMsgType + ":" + strService;
+	strFields[MULTI2MAC_TYPE]		= strMsgType + ":" + strValues[PIX_FIELD_SERVICE];
 	strFields[MULTI2MAC_LOG]		= "---------pix";
 	strFields[MULTI2MAC_FROM]		= strSrc;
 	strFields[MULTI2MAC_TO]			= strDst;
 	strFields[MULTI2MAC_SIZE]		= strBytes;
 	strFields[MULTI2MAC_ATIME]		= (timeVal > 0 ? boost_lexical_cast_wrapper<string>(timeVal) : "");
-	//strFields[MULTI2MAC_MTIME]	= 
-	//strFields[MULTI2MAC_CTIME]	= 
-	//strFields[MULTI2MAC_BTIME]	= 
+	//strFields[MULTI2MAC_MTIME]	=
+	//strFields[MULTI2MAC_CTIME]	=
+	//strFields[MULTI2MAC_BTIME]	=
 }
-
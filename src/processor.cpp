@@ -17,8 +17,14 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
 
 #include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
 using namespace std;
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
@@ -26,6 +32,128 @@ using namespace std;
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
+// --start/--end; parsers call inTimeWindow() as soon as a row's time is decoded so rows outside the window skip the
+// rest of their extraction.
+static u_int32_t uiTimeWindowStart = 0;
+static u_int32_t uiTimeWindowEnd = 0xffffffff;
+static u_int64_t uiTimeFailures = 0;
+
+static const char* MULTI2MAC_COLUMNS[] = { "HASH", "DETAIL", "TYPE", "LOG", "FROM", "TO", "SIZE", "ATIME", "MTIME", "CTIME", "BTIME" };
+
+string getSpanString(const string* pstrData, const textSpan& span) {
+	return (span.len ? pstrData->substr(span.pos, span.len) : "");
+}
+
+// Builds the '|' delimited output line (with trailing newline) for a row of fields.
+void formatBodyRow(string* strFields, string* pstrRow) {
+	// Do some rudimentary cleanup on the data; since '|' is a field delimiter, it cannot be in the final output.
+	replace(strFields[MULTI2MAC_HASH].begin(), strFields[MULTI2MAC_HASH].end(), '|', '-');
+	replace(strFields[MULTI2MAC_DETAIL].begin(), strFields[MULTI2MAC_DETAIL].end(), '|', '-');
+	replace(strFields[MULTI2MAC_TYPE].begin(), strFields[MULTI2MAC_TYPE].end(), '|', '-');
+	replace(strFields[MULTI2MAC_LOG].begin(), strFields[MULTI2MAC_LOG].end(), '|', '-');
+	replace(strFields[MULTI2MAC_FROM].begin(), strFields[MULTI2MAC_FROM].end(), '|', '-');
+	replace(strFields[MULTI2MAC_TO].begin(), strFields[MULTI2MAC_TO].end(), '|', '-');
+
+	pstrRow->clear();
+	for (int i=MULTI2MAC_HASH; i<=MULTI2MAC_BTIME; i++) {
+		pstrRow->append(strFields[i]);
+		pstrRow->push_back(i < MULTI2MAC_BTIME ? '|' : '\n');
+	}
+}
+
+// Earliest of the row's ATIME/MTIME/CTIME/BTIME values, or 0 if it has none.
+u_int32_t getBodyRowTime(const string* strFields) {
+	u_int32_t rv = 0;
+	for (int i=MULTI2MAC_ATIME; i<=MULTI2MAC_BTIME; i++) {
+		if (strFields[i].length()) {
+			u_int32_t uiTime = strtoul(strFields[i].c_str(), NULL, 10);
+			if (uiTime && (!rv || uiTime < rv)) {
+				rv = uiTime;
+			}
+		}
+	}
+	return rv;
+}
+
+void setTimeWindow(u_int32_t uiStart, u_int32_t uiEnd) {
+	uiTimeWindowStart = uiStart;
+	uiTimeWindowEnd = uiEnd;
+}
+
+// Times that could not be decoded (<= 0) pass so that conversion problems remain visible in the output.
+bool inTimeWindow(int32_t timeVal) {
+	return (timeVal <= 0 || (uiTimeWindowStart <= (u_int32_t)timeVal && (u_int32_t)timeVal <= uiTimeWindowEnd));
+}
+
+// A row is in the window if any of its times is (or it has none).
+bool rowInTimeWindow(const string* strFields) {
+	if (uiTimeWindowStart == 0 && uiTimeWindowEnd == 0xffffffff) {
+		return true;
+	}
+
+	bool bTimed = false;
+	for (int i=MULTI2MAC_ATIME; i<=MULTI2MAC_BTIME; i++) {
+		if (strFields[i].length()) {
+			int32_t timeVal = strtol(strFields[i].c_str(), NULL, 10);
+			if (timeVal > 0) {
+				if (inTimeWindow(timeVal)) {
+					return true;
+				}
+				bTimed = true;
+			}
+		}
+	}
+	return !bTimed;
+}
+
+// Every time conversion that fails, in the helpers below or in a parser calling createLocalTime() itself, calls
+// countTimeFailure() so that --stats sees all of them.
+void countTimeFailure() {
+	uiTimeFailures++;
+}
+
+u_int64_t getTimeFailures() {
+	return uiTimeFailures;
+}
+
+int getColumnByName(const string& strName) {
+	for (int i=0; i<(int)(sizeof(MULTI2MAC_COLUMNS)/sizeof(MULTI2MAC_COLUMNS[0])); i++) {
+		if (strName == MULTI2MAC_COLUMNS[i]) {
+			return i;
+		}
+	}
+	return (strName == "LOG-SRC" ? MULTI2MAC_LOG : -1);
+}
+
+// Seconds on the given clock; CLOCK_MONOTONIC for intervals (--progress, --checkpoint, --stats wall time).
+double getClock(clockid_t clock) {
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Quotes/escapes a value for JSON (--stats, --trace) and for Prometheus label values, which share the same rules
+// for '"' and '\'.
+string getQuoted(const string& strValue) {
+	string rv = "\"";
+	for (string::const_iterator it = strValue.begin(); it != strValue.end(); it++) {
+		if (*it == '"' || *it == '\\') {
+			rv.push_back('\\');
+			rv.push_back(*it);
+		} else if (*it == '\n') {
+			rv.append("\\n");
+		} else if ((unsigned char)*it < 0x20) {
+			char cstrEscape[8];
+			snprintf(cstrEscape, sizeof(cstrEscape), "\\u%04x", *it);
+			rv.append(cstrEscape);
+		} else {
+			rv.push_back(*it);
+		}
+	}
+	rv.push_back('"');
+	return rv;
+}
+
 // TODO Unix32 is unable to handle dates past the year 2038...
 
 int32_t getUnix32DateTimeFromString2(string strDateTime, char chSeparator, char chDateDelim, char chTimeDelim, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
@@ -88,6 +216,7 @@ int32_t getUnix32DateTimeFromString(string strDateTime, char chSeparator, char c
 int32_t getUnix32FromStrings(string strMonth, string strDay, string strYear, string strHour, string strMinute, string strSecond, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
 	DEBUG("getUnix32FromStrings() " << strMonth << "-" << strDay << "-" << strYear << " " << strHour << ":" << strMinute << ":" << strSecond << ")"); 
 	int32_t rv = -1;
+	traceStage stage(SPANTRACER_STAGE_TIME);
 
 	try {
 		boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
@@ -100,12 +229,36 @@ int32_t getUnix32FromStrings(string strMonth, string strDay, string strYear, str
 												&ldt)) {
 			rv = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
 		} else {
-			ERROR("getUnix32FromStrings() Unable to createLocalTime(" << strMonth << "-" << strDay << "-" << strYear << " " << strHour << ":" << strMinute << ":" << strSecond << ")");
+			ROW_ERROR("getUnix32FromStrings() Unable to createLocalTime()", " (" << strMonth << "-" << strDay << "-" << strYear << " " << strHour << ":" << strMinute << ":" << strSecond << ")");
 		}
 	} catch (...) {
-		ERROR("getUnix32FromStrings() Caught exception converting string (" << strMonth << "-" << strDay << "-" << strYear << " " << strHour << ":" << strMinute << ":" << strSecond << ")");
+		ROW_ERROR("getUnix32FromStrings() Caught exception converting string", " (" << strMonth << "-" << strDay << "-" << strYear << " " << strHour << ":" << strMinute << ":" << strSecond << ")");
+	}
+	if (rv < 0) {
+		countTimeFailure();
 	}
 
 	return rv;
 }
 
+int32_t getUnix32FromLayout(string strTime, string strLayout, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
+	DEBUG("getUnix32FromLayout() " << strTime << " (" << strLayout << ")");
+	int32_t rv = -1;
+	traceStage stage(SPANTRACER_STAGE_TIME);
+
+	try {
+		boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
+		if (pTZCalc->createLocalTime(strTime, strLayout, &ldt)) {
+			rv = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
+		} else {
+			ROW_ERROR("getUnix32FromLayout() Unable to createLocalTime()", " (" << strTime << ")");
+		}
+	} catch (...) {
+		ROW_ERROR("getUnix32FromLayout() Caught exception converting string", " (" << strTime << ")");
+	}
+	if (rv < 0) {
+		countTimeFailure();
+	}
+
+	return rv;
+}
@@ -16,6 +16,7 @@
 #define MULTI2MACTIME_PROCESSOR_H_
 
 #include <string>
+#include <ctime>
 using namespace std;
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
@@ -44,20 +45,47 @@ using namespace std;
 #define MULTI2MAC_CTIME		TSK3_MACTIME_CTIME
 #define MULTI2MAC_BTIME		TSK3_MACTIME_CRTIME
 
+// Position/length of a value within a line of input; lets parsers locate values without copying them.
+struct textSpan {
+	size_t pos;
+	size_t len;
+};
+
+struct syslogHeader;	// syslog.h
+
+// Cheap extraction of just a row's time (as it will appear in the output), used to seek within time ordered inputs.
+typedef int32_t (*rowTimeFunc)(const string* pstrData, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
+
 void processExifTool(string* pstrData, string* pstrHeader, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, string* strSecondary);
 void processNotes(string* pstrData, string* pstrHeader, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
 void processIEF(string* pstrData, string* pstrHeader, string* pstrFilename, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, string* strSecondary);
 void processGriffeyeCSV(string* pstrData, string* pstrHeader, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
 void processHirsch(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+int32_t getFortiGate1K5Time(const string* pstrData, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
 void processFortiGate1K5(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+void processFortiGateSyslog(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader = NULL);
+int32_t getSquidW3cTime(const string* pstrData, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
 void processSquidW3c(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, string* strSecondary);
 void processCustomVPN_S1(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
 void processCustomFSEM(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
 void processCustomFSBT(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
-void processSymantec(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
-void processJuniper(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
-void processPIX(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+void processSymantec(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader = NULL);
+void processJuniper(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader = NULL);
+bool loadPIXPrograms(string strFilename);
+void processPIX(string* pstrData, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader = NULL);
 
+string getSpanString(const string* pstrData, const textSpan& span);
+void formatBodyRow(string* strFields, string* pstrRow);
+u_int32_t getBodyRowTime(const string* strFields);
+int getColumnByName(const string& strName);
+string getQuoted(const string& strValue);
+double getClock(clockid_t clock = CLOCK_MONOTONIC);
+void setTimeWindow(u_int32_t uiStart, u_int32_t uiEnd);
+bool inTimeWindow(int32_t timeVal);
+bool rowInTimeWindow(const string* strFields);
+void countTimeFailure();
+u_int64_t getTimeFailures();
+int32_t getUnix32FromLayout(string strTime, string strLayout, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
 int32_t getUnix32FromStrings(string strMonth, string strDay, string strYear, string strHour, string strMinute, string strSecond, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
 int32_t getUnix32DateTimeFromString(string strDateTime, char chSeparator, char chDateDelim, char chTimeDelim, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
 int32_t getUnix32DateTimeFromString2(string strDateTime, char chSeparator, char chDateDelim, char chTimeDelim, u_int32_t uiSkew, timeZoneCalculator* pTZCalc);
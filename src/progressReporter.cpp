@@ -0,0 +1,158 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "progressReporter.h"
+#include "processor.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+// h:mm:ss
+static string getDuration(double dSeconds) {
+	u_int64_t uiSeconds = (u_int64_t)(dSeconds + 0.5);
+	char cstrDuration[32];
+	snprintf(cstrDuration, sizeof(cstrDuration), "%llu:%02u:%02u", (unsigned long long)(uiSeconds / 3600), (unsigned)(uiSeconds / 60 % 60), (unsigned)(uiSeconds % 60));
+	return cstrDuration;
+}
+
+progressReporter::progressReporter(bool bStderr, string strStatusFile) : m_bStderr(bStderr), m_bTerminal(bStderr && isatty(STDERR_FILENO)), m_strStatusFile(strStatusFile),
+		m_uiTotal(0), m_bTotalKnown(true), m_uiBase(0), m_uiBytes(0), m_uiRows(0), m_uiFiles(0), m_bStopping(false), m_dStart(0), m_dLast(0), m_uiLastBytes(0), m_uiLastRows(0) {
+}
+
+progressReporter::~progressReporter() {
+	stop();
+}
+
+void progressReporter::addFile(string strFilename) {
+	struct stat st;
+	u_int64_t uiSize = 0;
+	if (strFilename != "" && stat(strFilename.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+		uiSize = st.st_size;
+	} else {
+		m_bTotalKnown = false;
+	}
+	m_vecSizes.push_back(uiSize);
+	m_uiTotal += uiSize;
+}
+
+void progressReporter::endFile(size_t uiFile) {
+	m_uiBase = (m_vecSizes[uiFile] ? m_uiBase + m_vecSizes[uiFile] : m_uiBytes.load(memory_order_relaxed));
+	m_uiBytes.store(m_uiBase, memory_order_relaxed);
+	m_uiFiles.store(m_uiFiles.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+void progressReporter::start() {
+	m_dStart = m_dLast = getClock();
+	m_thread = thread(&progressReporter::reporterLoop, this);
+}
+
+// Joins the reporter and writes the final line/status
+void progressReporter::stop() {
+	if (!m_thread.joinable()) {
+		return;
+	}
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_cvStop.notify_one();
+	m_thread.join();
+	report(true);
+}
+
+void progressReporter::reporterLoop() {
+	unique_lock<mutex> lock(m_mutex);
+	while (!m_cvStop.wait_for(lock, chrono::milliseconds(PROGRESSREPORTER_INTERVAL_MS), [this] { return m_bStopping; })) {
+		report(false);
+	}
+}
+
+void progressReporter::report(bool bFinal) {
+	double dNow = getClock();
+	u_int64_t uiBytes = m_uiBytes.load(memory_order_relaxed);
+	u_int64_t uiRows = m_uiRows.load(memory_order_relaxed);
+	u_int64_t uiFiles = m_uiFiles.load(memory_order_relaxed);
+
+	// Current rates over the last interval; the ETA uses the average so far, which is steadier
+	double dInterval = (bFinal ? dNow - m_dStart : dNow - m_dLast);
+	double dRowsPerSec = (dInterval > 0 ? (bFinal ? uiRows : uiRows - m_uiLastRows) / dInterval : 0);
+	double dMBPerSec = (dInterval > 0 ? (bFinal ? uiBytes : uiBytes - m_uiLastBytes) / dInterval / 1e6 : 0);
+	double dElapsed = dNow - m_dStart;
+	double dETA = -1;
+	if (m_bTotalKnown && uiBytes > 0 && uiBytes <= m_uiTotal) {
+		dETA = (m_uiTotal - uiBytes) * dElapsed / uiBytes;
+	}
+	m_dLast = dNow;
+	m_uiLastBytes = uiBytes;
+	m_uiLastRows = uiRows;
+
+	if (m_bStderr) {
+		stringstream ssLine;
+		ssLine << "progress: " << fixed << setprecision(1) << uiBytes / 1e6 << " MB";
+		if (m_bTotalKnown) {
+			ssLine << " of " << m_uiTotal / 1e6 << " MB (" << (m_uiTotal ? 100.0 * uiBytes / m_uiTotal : 100.0) << "%)";
+		}
+		ssLine << ", " << uiFiles << "/" << m_vecSizes.size() << " files done, " << uiRows << " rows, "
+				 << setprecision(0) << dRowsPerSec << " rows/s, " << setprecision(1) << dMBPerSec << " MB/s";
+		if (bFinal) {
+			ssLine << ", done in " << getDuration(dElapsed);
+		} else {
+			ssLine << ", ETA " << (dETA >= 0 ? getDuration(dETA) : "unknown");
+		}
+		// Redraw in place on a terminal; padded to cover a longer previous line
+		if (m_bTerminal) {
+			LOG_LOCKED(cerr << "\r" << left << setw(100) << ssLine.str() << (bFinal ? "\n" : "") << flush);
+		} else {
+			LOG_LOCKED(cerr << ssLine.str() << "\n" << flush);
+		}
+	}
+
+	if (m_strStatusFile != "") {
+		string strTemp = m_strStatusFile + ".tmp";
+		ofstream fileStatus(strTemp.c_str());
+		fileStatus << "{\"bytes\": " << uiBytes << ", \"total_bytes\": ";
+		if (m_bTotalKnown) {
+			fileStatus << m_uiTotal;
+		} else {
+			fileStatus << "null";
+		}
+		fileStatus << ", \"files_done\": " << uiFiles << ", \"files\": " << m_vecSizes.size() << ", \"rows\": " << uiRows << fixed << setprecision(1)
+					  << ", \"rows_per_second\": " << dRowsPerSec << ", \"mb_per_second\": " << dMBPerSec << ", \"elapsed_seconds\": " << dElapsed << ", \"eta_seconds\": ";
+		if (!bFinal && dETA >= 0) {
+			fileStatus << dETA;
+		} else {
+			fileStatus << (bFinal ? "0" : "null");
+		}
+		fileStatus << ", \"done\": " << (bFinal ? "true" : "false") << "}\n";
+		fileStatus.close();
+		if (!fileStatus || rename(strTemp.c_str(), m_strStatusFile.c_str()) != 0) {
+			LOG_ERROR("progressReporter::report() Unable to write " << m_strStatusFile);
+		}
+	}
+}
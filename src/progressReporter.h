@@ -0,0 +1,82 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_PROGRESSREPORTER_H_
+#define MULTI2MACTIME_PROGRESSREPORTER_H_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+using namespace std;
+
+// --progress/--progress-file: every PROGRESSREPORTER_INTERVAL_MS a background thread reads the counters below and
+// reports bytes read against the total size of the inputs, rows/s and MB/s over the last interval and an ETA from the
+// average rate so far. On a terminal the stderr line is redrawn in place; the status file is replaced (rename) with one
+// line of JSON each time, so a reader never sees a partial update.
+//
+// The main thread is the only writer of the counters, so a row costs two relaxed loads and stores and no locked
+// instructions. Stdin and other inputs without a size leave the total, percentage and ETA unknown.
+
+#define PROGRESSREPORTER_INTERVAL_MS	2000
+
+class progressReporter {
+	public:
+		progressReporter(bool bStderr, string strStatusFile);
+		~progressReporter();
+
+		void addFile(string strFilename);
+		void start();
+		void stop();
+
+		void addRow(u_int64_t uiBytes) {
+			m_uiBytes.store(m_uiBytes.load(memory_order_relaxed) + uiBytes, memory_order_relaxed);
+			m_uiRows.store(m_uiRows.load(memory_order_relaxed) + 1, memory_order_relaxed);
+		}
+		// Counts the whole file as read (rows skipped by --start/--end seeking or after the end time included)
+		void endFile(size_t uiFile);
+
+	private:
+		progressReporter(const progressReporter&);
+		progressReporter& operator=(const progressReporter&);
+
+		void reporterLoop();
+		void report(bool bFinal);
+
+		bool m_bStderr;
+		bool m_bTerminal;
+		string m_strStatusFile;
+		vector<u_int64_t> m_vecSizes;			// 0 if unknown
+		u_int64_t m_uiTotal;
+		bool m_bTotalKnown;
+		u_int64_t m_uiBase;						// bytes of the files endFile() has been called for
+
+		atomic<u_int64_t> m_uiBytes;
+		atomic<u_int64_t> m_uiRows;
+		atomic<u_int64_t> m_uiFiles;				// completed
+
+		// Reporter thread
+		thread m_thread;
+		mutex m_mutex;
+		condition_variable m_cvStop;
+		bool m_bStopping;
+		double m_dStart;
+		double m_dLast;
+		u_int64_t m_uiLastBytes;
+		u_int64_t m_uiLastRows;
+};
+
+#endif /*MULTI2MACTIME_PROGRESSREPORTER_H_*/
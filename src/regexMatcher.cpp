@@ -0,0 +1,780 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "regexMatcher.h"
+#include "textSearch.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <bitset>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+using namespace std;
+
+#include "libtimeUtils/src/timeZoneCalculator.h"
+#include "misc/boost_lexical_cast_wrapper.hpp"
+
+regexMatcher::regexMatcher() : m_posPattern(0), m_uiSlots(0), m_bAnchored(false), m_bOnePass(false), m_uiGeneration(0) {
+}
+
+bool regexMatcher::compile(const string& strPattern) {
+	m_strPattern = strPattern;
+	m_posPattern = 0;
+	m_strError = "";
+	m_vecProgram.clear();
+	m_vecClasses.clear();
+	m_vecCaptureColumns.clear();
+
+	bool rv = parseAlternation();
+	if (rv && m_posPattern < m_strPattern.length()) {
+		m_strError = "unmatched ')'";
+		rv = false;
+	}
+	if (rv && m_vecProgram.size() >= REGEX_MAX_PROGRAM) {
+		m_strError = "pattern too large";
+		rv = false;
+	}
+	if (!rv) {
+		LOG_ERROR("regexMatcher::compile() Invalid pattern at offset " << m_posPattern << ", " << m_strError << " (" << m_strPattern << ")");
+		return false;
+	}
+	emit(REGEX_OP_MATCH);
+
+	// A run of literals that every match must start with lets match() skip straight to candidate positions.
+	m_strPrefix = "";
+	size_t pc = 0;
+	while (m_vecProgram[pc].uiOp == REGEX_OP_SAVE) {
+		pc++;
+	}
+	m_bAnchored = (m_vecProgram[pc].uiOp == REGEX_OP_BOL);
+	for (; !m_bAnchored && (m_vecProgram[pc].uiOp == REGEX_OP_CHAR || m_vecProgram[pc].uiOp == REGEX_OP_SAVE); pc++) {
+		if (m_vecProgram[pc].uiOp == REGEX_OP_CHAR) {
+			m_strPrefix += (char)m_vecProgram[pc].ch;
+		}
+	}
+
+	m_uiSlots = m_vecCaptureColumns.size() * 2;
+	for (int i=0; i<2; i++) {
+		m_lists[i].vecPCs.assign(m_vecProgram.size(), 0);
+		m_lists[i].vecCaps.assign(m_vecProgram.size() * m_uiSlots + 1, string::npos);
+		m_lists[i].count = 0;
+	}
+	m_vecSeen.assign(m_vecProgram.size(), 0);
+	m_uiGeneration = 0;
+	m_vecStartCaps.assign(m_uiSlots + 1, string::npos);
+	m_vecMatchCaps.assign(m_uiSlots + 1, string::npos);
+	m_vecThreadCaps.assign(m_uiSlots + 1, string::npos);
+
+	m_bOnePass = (m_bAnchored && compileOnePass());
+	if (!m_bOnePass) {
+		m_vecOnePass.clear();
+		m_vecOnePassStates.clear();
+	}
+
+	DEBUG("regexMatcher::compile() " << m_vecProgram.size() << " instructions, " << m_vecClasses.size() << " classes, " << m_vecCaptureColumns.size() << " captures, prefix (" << m_strPrefix << "), one-pass " << m_bOnePass);
+	return true;
+}
+
+bool regexMatcher::parseAlternation() {
+	size_t posAlternative = m_vecProgram.size();
+	vector<size_t> vecJumps;
+
+	if (!parseConcatenation()) {
+		return false;
+	}
+	while (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] == '|') {
+		m_posPattern++;
+
+		regexInstr split = { REGEX_OP_SPLIT, 0, (u_int32_t)posAlternative + 1, 0 };
+		insert(posAlternative, split);
+		vecJumps.push_back(m_vecProgram.size());
+		emit(REGEX_OP_JMP);
+		m_vecProgram[posAlternative].y = m_vecProgram.size();
+		posAlternative = m_vecProgram.size();
+
+		if (!parseConcatenation()) {
+			return false;
+		}
+	}
+	for (vector<size_t>::iterator it = vecJumps.begin(); it != vecJumps.end(); it++) {
+		m_vecProgram[*it].x = m_vecProgram.size();
+	}
+
+	return true;
+}
+
+bool regexMatcher::parseConcatenation() {
+	while (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] != '|' && m_strPattern[m_posPattern] != ')') {
+		if (!parseRepetition()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool regexMatcher::parseRepetition() {
+	size_t posStart = m_vecProgram.size();
+	if (!parseAtom()) {
+		return false;
+	}
+
+	while (m_posPattern < m_strPattern.length()) {
+		char ch = m_strPattern[m_posPattern];
+		size_t uiMin = 0;
+		size_t uiMax = string::npos;
+		if (ch == '*') {
+		} else if (ch == '+') {
+			uiMin = 1;
+		} else if (ch == '?') {
+			uiMax = 1;
+		} else if (ch == '{') {
+			m_posPattern++;
+			if (!parseCount(&uiMin)) {
+				return false;
+			}
+			uiMax = uiMin;
+			if (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] == ',') {
+				m_posPattern++;
+				uiMax = string::npos;
+				if (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] != '}' && !parseCount(&uiMax)) {
+					return false;
+				}
+			}
+			if (m_posPattern >= m_strPattern.length() || m_strPattern[m_posPattern] != '}' || uiMax < uiMin) {
+				m_strError = "invalid {n,m} repetition";
+				return false;
+			}
+		} else {
+			break;
+		}
+		m_posPattern++;
+
+		bool bGreedy = true;
+		if (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] == '?') {
+			bGreedy = false;
+			m_posPattern++;
+		}
+
+		if (ch == '*') {
+			emitStar(posStart, bGreedy);
+		} else if (ch == '+') {
+			emit(REGEX_OP_SPLIT, 0, (bGreedy ? posStart : m_vecProgram.size() + 1), (bGreedy ? m_vecProgram.size() + 1 : posStart));
+		} else if (ch == '?') {
+			emitOptional(posStart, bGreedy);
+		} else {
+			// Counted repetition is expanded into copies of the atom: x{2,4} becomes xxx?x?
+			vector<regexInstr> vecFragment(m_vecProgram.begin() + posStart, m_vecProgram.end());
+			size_t uiCopies = (uiMax != string::npos ? uiMax : uiMin + 1);
+			if (vecFragment.size() * uiCopies >= REGEX_MAX_PROGRAM) {
+				m_strError = "repetition too large";
+				return false;
+			}
+
+			m_vecProgram.resize(posStart);
+			for (size_t i=0; i<uiMin; i++) {
+				appendFragment(vecFragment, posStart);
+			}
+			if (uiMax == string::npos) {
+				size_t posCopy = m_vecProgram.size();
+				appendFragment(vecFragment, posStart);
+				emitStar(posCopy, bGreedy);
+			} else {
+				for (size_t i=uiMin; i<uiMax; i++) {
+					size_t posCopy = m_vecProgram.size();
+					appendFragment(vecFragment, posStart);
+					emitOptional(posCopy, bGreedy);
+				}
+			}
+		}
+
+		if (m_vecProgram.size() >= REGEX_MAX_PROGRAM) {
+			m_strError = "pattern too large";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool regexMatcher::parseAtom() {
+	char ch = m_strPattern[m_posPattern++];
+	switch (ch) {
+		case '(': {
+			int iCapture = -1;
+			if (m_strPattern.compare(m_posPattern, 2, "?:") == 0) {
+				m_posPattern += 2;
+			} else if (m_strPattern.compare(m_posPattern, 2, "?<") == 0 || m_strPattern.compare(m_posPattern, 3, "?P<") == 0) {
+				m_posPattern += (m_strPattern[m_posPattern + 1] == 'P' ? 3 : 2);
+				size_t posEnd = m_strPattern.find('>', m_posPattern);
+				if (posEnd == string::npos) {
+					m_strError = "unterminated group name";
+					return false;
+				}
+				string strName = m_strPattern.substr(m_posPattern, posEnd - m_posPattern);
+				int iColumn = getColumnByName(strName);
+				if (iColumn < 0) {
+					m_strError = "unknown column (" + strName + ")";
+					return false;
+				} else if (find(m_vecCaptureColumns.begin(), m_vecCaptureColumns.end(), iColumn) != m_vecCaptureColumns.end()) {
+					m_strError = "duplicate column (" + strName + ")";
+					return false;
+				}
+				m_posPattern = posEnd + 1;
+				iCapture = m_vecCaptureColumns.size();
+				m_vecCaptureColumns.push_back(iColumn);
+			} else if (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] == '?') {
+				m_strError = "unsupported group type";
+				return false;
+			}
+
+			if (iCapture >= 0) {
+				emit(REGEX_OP_SAVE, 0, iCapture * 2);
+			}
+			if (!parseAlternation()) {
+				return false;
+			}
+			if (m_posPattern >= m_strPattern.length() || m_strPattern[m_posPattern] != ')') {
+				m_strError = "missing ')'";
+				return false;
+			}
+			m_posPattern++;
+			if (iCapture >= 0) {
+				emit(REGEX_OP_SAVE, 0, iCapture * 2 + 1);
+			}
+			break;
+		}
+
+		case '*':
+		case '+':
+		case '?':
+		case '{':
+			m_strError = "nothing to repeat";
+			return false;
+
+		case '.':
+			emit(REGEX_OP_ANY);
+			break;
+
+		case '^':
+			emit(REGEX_OP_BOL);
+			break;
+
+		case '$':
+			emit(REGEX_OP_EOL);
+			break;
+
+		case '[': {
+			bitset<256> cls;
+			if (!parseClass(&cls)) {
+				return false;
+			}
+			emit(REGEX_OP_CLASS, 0, m_vecClasses.size());
+			m_vecClasses.push_back(cls);
+			break;
+		}
+
+		case '\\': {
+			int iChar = -1;
+			bitset<256> cls;
+			if (!parseEscape(&iChar, &cls)) {
+				return false;
+			}
+			if (iChar >= 0) {
+				emit(REGEX_OP_CHAR, iChar);
+			} else {
+				emit(REGEX_OP_CLASS, 0, m_vecClasses.size());
+				m_vecClasses.push_back(cls);
+			}
+			break;
+		}
+
+		default:
+			emit(REGEX_OP_CHAR, ch);
+			break;
+	}
+
+	return true;
+}
+
+bool regexMatcher::parseClass(bitset<256>* pClass) {
+	bool bNegate = false;
+	if (m_posPattern < m_strPattern.length() && m_strPattern[m_posPattern] == '^') {
+		bNegate = true;
+		m_posPattern++;
+	}
+
+	bool bFirst = true;
+	while (m_posPattern < m_strPattern.length() && (bFirst || m_strPattern[m_posPattern] != ']')) {
+		bFirst = false;
+
+		int iLow = (unsigned char)m_strPattern[m_posPattern++];
+		if (iLow == '\\') {
+			bitset<256> cls;
+			iLow = -1;
+			if (!parseEscape(&iLow, &cls)) {
+				return false;
+			}
+			if (iLow < 0) {
+				*pClass |= cls;
+				continue;
+			}
+		}
+
+		int iHigh = iLow;
+		if (m_posPattern + 1 < m_strPattern.length() && m_strPattern[m_posPattern] == '-' && m_strPattern[m_posPattern + 1] != ']') {
+			m_posPattern++;
+			iHigh = (unsigned char)m_strPattern[m_posPattern++];
+			if (iHigh == '\\') {
+				bitset<256> cls;
+				iHigh = -1;
+				if (!parseEscape(&iHigh, &cls) || iHigh < 0) {
+					m_strError = "invalid class range";
+					return false;
+				}
+			}
+			if (iHigh < iLow) {
+				m_strError = "invalid class range";
+				return false;
+			}
+		}
+		for (int i=iLow; i<=iHigh; i++) {
+			pClass->set(i);
+		}
+	}
+
+	if (m_posPattern >= m_strPattern.length()) {
+		m_strError = "missing ']'";
+		return false;
+	}
+	m_posPattern++;
+
+	if (bNegate) {
+		pClass->flip();
+	}
+	return true;
+}
+
+// Parses the character following a '\'; sets either *pChar (a single character) or *pClass (\d \w \s and negations).
+bool regexMatcher::parseEscape(int* pChar, bitset<256>* pClass) {
+	if (m_posPattern >= m_strPattern.length()) {
+		m_strError = "trailing '\\'";
+		return false;
+	}
+
+	char ch = m_strPattern[m_posPattern++];
+	switch (ch) {
+		case 't':	*pChar = '\t';	return true;
+		case 'n':	*pChar = '\n';	return true;
+		case 'r':	*pChar = '\r';	return true;
+		case 'd':
+		case 'D':
+		case 'w':
+		case 'W':
+		case 's':
+		case 'S':
+			pClass->reset();
+			for (int i=0; i<256; i++) {
+				char lower = tolower(ch);
+				if ((lower == 'd' && isdigit(i)) || (lower == 'w' && (isalnum(i) || i == '_')) || (lower == 's' && isspace(i))) {
+					pClass->set(i);
+				}
+			}
+			if (isupper(ch)) {
+				pClass->flip();
+			}
+			return true;
+		default:
+			if (isalnum(ch)) {
+				m_strError = string("unsupported escape \\") + ch;
+				return false;
+			}
+			*pChar = (unsigned char)ch;
+			return true;
+	}
+}
+
+bool regexMatcher::parseCount(size_t* pCount) {
+	size_t posStart = m_posPattern;
+	while (m_posPattern < m_strPattern.length() && isdigit(m_strPattern[m_posPattern])) {
+		m_posPattern++;
+	}
+	if (m_posPattern == posStart || m_posPattern - posStart > 5) {
+		m_strError = "invalid {n,m} repetition";
+		return false;
+	}
+	*pCount = strtoul(m_strPattern.substr(posStart, m_posPattern - posStart).c_str(), NULL, 10);
+	return true;
+}
+
+void regexMatcher::emit(u_int8_t uiOp, u_int8_t ch, u_int32_t x, u_int32_t y) {
+	regexInstr instr = { uiOp, ch, x, y };
+	m_vecProgram.push_back(instr);
+}
+
+// Inserts an instruction in front of the fragment that starts at pos; jumps within the fragment (and to its end)
+// move with it.
+void regexMatcher::insert(size_t pos, const regexInstr& instr) {
+	for (size_t i=pos; i<m_vecProgram.size(); i++) {
+		regexInstr& target = m_vecProgram[i];
+		if (target.uiOp == REGEX_OP_JMP || target.uiOp == REGEX_OP_SPLIT) {
+			target.x += (target.x >= pos ? 1 : 0);
+			target.y += (target.uiOp == REGEX_OP_SPLIT && target.y >= pos ? 1 : 0);
+		}
+	}
+	m_vecProgram.insert(m_vecProgram.begin() + pos, instr);
+}
+
+void regexMatcher::appendFragment(const vector<regexInstr>& vecFragment, size_t posOrigin) {
+	u_int32_t uiShift = m_vecProgram.size() - posOrigin;
+	for (vector<regexInstr>::const_iterator it = vecFragment.begin(); it != vecFragment.end(); it++) {
+		regexInstr instr = *it;
+		if (instr.uiOp == REGEX_OP_JMP || instr.uiOp == REGEX_OP_SPLIT) {
+			instr.x += uiShift;
+			instr.y += (instr.uiOp == REGEX_OP_SPLIT ? uiShift : 0);
+		}
+		m_vecProgram.push_back(instr);
+	}
+}
+
+void regexMatcher::emitStar(size_t posStart, bool bGreedy) {
+	regexInstr split = { REGEX_OP_SPLIT, 0, 0, 0 };
+	insert(posStart, split);
+	emit(REGEX_OP_JMP, 0, posStart);
+	m_vecProgram[posStart].x = (bGreedy ? posStart + 1 : m_vecProgram.size());
+	m_vecProgram[posStart].y = (bGreedy ? m_vecProgram.size() : posStart + 1);
+}
+
+void regexMatcher::emitOptional(size_t posStart, bool bGreedy) {
+	regexInstr split = { REGEX_OP_SPLIT, 0, 0, 0 };
+	insert(posStart, split);
+	m_vecProgram[posStart].x = (bGreedy ? posStart + 1 : m_vecProgram.size());
+	m_vecProgram[posStart].y = (bGreedy ? m_vecProgram.size() : posStart + 1);
+}
+
+// Builds the one-pass DFA: each state is the position after a consuming instruction (or the start), and its
+// transitions come from the epsilon closure of that position. Returns false as soon as a byte could continue along
+// two different paths, in which case the pattern is left to the Pike VM.
+bool regexMatcher::compileOnePass() {
+	m_vecOnePass.clear();
+	m_vecOnePassStates.clear();
+	m_vecOnePassIndex.assign(m_vecProgram.size(), -1);
+
+	getOnePassState(0);
+	for (u_int32_t uiState=0; uiState<m_vecOnePassStates.size(); uiState++) {
+		if (m_vecOnePassStates.size() > REGEX_MAX_ONEPASS) {
+			return false;
+		}
+		nextGeneration();
+		bool bCut = false;
+		if (!onePassClosure(uiState, m_vecOnePassStates[uiState].pc, 0, &bCut)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32_t regexMatcher::getOnePassState(u_int32_t pc) {
+	if (m_vecOnePassIndex[pc] < 0) {
+		onePassState state = { pc, REGEX_MATCH_NONE, 0 };
+		onePassTransition none = { -1, 0 };
+		m_vecOnePassIndex[pc] = m_vecOnePassStates.size();
+		m_vecOnePassStates.push_back(state);
+		m_vecOnePass.resize(m_vecOnePass.size() + 256, none);
+	}
+	return m_vecOnePassIndex[pc];
+}
+
+// Walks the epsilon closure in priority order, as addThread() would. Consuming instructions reached after an
+// unconditional MATCH are cut (*pbCut) exactly as the Pike VM cuts lower priority threads.
+bool regexMatcher::onePassClosure(u_int32_t uiState, u_int32_t pc, u_int32_t uiSaves, bool* pbCut) {
+	if (m_vecSeen[pc] == m_uiGeneration) {
+		return true;
+	}
+	m_vecSeen[pc] = m_uiGeneration;
+
+	const regexInstr& instr = m_vecProgram[pc];
+	switch (instr.uiOp) {
+		case REGEX_OP_JMP:
+			return onePassClosure(uiState, instr.x, uiSaves, pbCut);
+
+		case REGEX_OP_SPLIT:
+			return (onePassClosure(uiState, instr.x, uiSaves, pbCut) && onePassClosure(uiState, instr.y, uiSaves, pbCut));
+
+		case REGEX_OP_SAVE:
+			return onePassClosure(uiState, pc + 1, uiSaves | (1 << instr.x), pbCut);
+
+		case REGEX_OP_BOL:
+			// Only the start state is ever evaluated at position 0
+			return (uiState == 0 && onePassClosure(uiState, pc + 1, uiSaves, pbCut));
+
+		case REGEX_OP_EOL:
+		case REGEX_OP_MATCH: {
+			// '$' is only supported directly in front of MATCH (possibly through closing groups)
+			int iMatch = REGEX_MATCH_ALWAYS;
+			if (instr.uiOp == REGEX_OP_EOL) {
+				iMatch = REGEX_MATCH_AT_END;
+				for (pc++; m_vecProgram[pc].uiOp == REGEX_OP_SAVE; pc++) {
+					uiSaves |= (1 << m_vecProgram[pc].x);
+				}
+				if (m_vecProgram[pc].uiOp != REGEX_OP_MATCH) {
+					return false;
+				}
+			}
+			onePassState& state = m_vecOnePassStates[uiState];
+			if (state.iMatch != REGEX_MATCH_NONE) {
+				return false;
+			}
+			state.iMatch = iMatch;
+			state.uiMatchSaves = uiSaves;
+			*pbCut = (iMatch == REGEX_MATCH_ALWAYS);
+			return true;
+		}
+
+		default: {
+			if (*pbCut) {
+				return true;
+			}
+			int32_t iNext = getOnePassState(pc + 1);
+			onePassTransition* pTransitions = &m_vecOnePass[uiState * 256];
+			for (int i=0; i<256; i++) {
+				if ((instr.uiOp == REGEX_OP_CHAR && i == instr.ch) || (instr.uiOp == REGEX_OP_CLASS && m_vecClasses[instr.x][i]) || instr.uiOp == REGEX_OP_ANY) {
+					if (pTransitions[i].iNext >= 0) {
+						return false;
+					}
+					pTransitions[i].iNext = iNext;
+					pTransitions[i].uiSaves = uiSaves;
+				}
+			}
+			return true;
+		}
+	}
+}
+
+static inline void applySaves(u_int32_t uiSaves, size_t pos, size_t* pCaps) {
+	while (uiSaves) {
+		pCaps[__builtin_ctz(uiSaves)] = pos;
+		uiSaves &= uiSaves - 1;
+	}
+}
+
+bool regexMatcher::matchOnePass(const string* pstrData) {
+	const unsigned char* pData = (const unsigned char*)pstrData->data();
+	size_t len = pstrData->length();
+	const onePassTransition* pTransitions = &m_vecOnePass[0];
+	size_t* pCaps = &m_vecThreadCaps[0];
+	bool bMatched = false;
+
+	fill(m_vecThreadCaps.begin(), m_vecThreadCaps.end(), string::npos);
+	int32_t iState = 0;
+	for (size_t pos=0; ; pos++) {
+		const onePassState& state = m_vecOnePassStates[iState];
+		if (state.iMatch == REGEX_MATCH_ALWAYS || (state.iMatch == REGEX_MATCH_AT_END && pos == len)) {
+			copy(m_vecThreadCaps.begin(), m_vecThreadCaps.end(), m_vecMatchCaps.begin());
+			applySaves(state.uiMatchSaves, pos, &m_vecMatchCaps[0]);
+			bMatched = true;
+		}
+		if (pos >= len) {
+			break;
+		}
+
+		const onePassTransition& next = pTransitions[iState * 256 + pData[pos]];
+		if (next.iNext < 0) {
+			break;
+		}
+		applySaves(next.uiSaves, pos, pCaps);
+		iState = next.iNext;
+	}
+
+	return bMatched;
+}
+
+void regexMatcher::nextGeneration() {
+	if (++m_uiGeneration == 0) {
+		fill(m_vecSeen.begin(), m_vecSeen.end(), 0);
+		m_uiGeneration = 1;
+	}
+}
+
+// Follows non-consuming instructions from pc and queues the threads that land on a consuming instruction (or MATCH),
+// in priority order. Each pc is queued at most once per generation, which is what keeps matching linear.
+void regexMatcher::addThread(threadList* pList, u_int32_t pc, size_t* pCaps, size_t pos, size_t len) {
+	if (m_vecSeen[pc] == m_uiGeneration) {
+		return;
+	}
+	m_vecSeen[pc] = m_uiGeneration;
+
+	const regexInstr& instr = m_vecProgram[pc];
+	switch (instr.uiOp) {
+		case REGEX_OP_JMP:
+			addThread(pList, instr.x, pCaps, pos, len);
+			break;
+
+		case REGEX_OP_SPLIT:
+			addThread(pList, instr.x, pCaps, pos, len);
+			addThread(pList, instr.y, pCaps, pos, len);
+			break;
+
+		case REGEX_OP_SAVE: {
+			size_t posSaved = pCaps[instr.x];
+			pCaps[instr.x] = pos;
+			addThread(pList, pc + 1, pCaps, pos, len);
+			pCaps[instr.x] = posSaved;
+			break;
+		}
+
+		case REGEX_OP_BOL:
+			if (pos == 0) {
+				addThread(pList, pc + 1, pCaps, pos, len);
+			}
+			break;
+
+		case REGEX_OP_EOL:
+			if (pos == len) {
+				addThread(pList, pc + 1, pCaps, pos, len);
+			}
+			break;
+
+		default:
+			pList->vecPCs[pList->count] = pc;
+			copy(pCaps, pCaps + m_uiSlots, &pList->vecCaps[pList->count * m_uiSlots]);
+			pList->count++;
+			break;
+	}
+}
+
+bool regexMatcher::match(const string* pstrData) {
+	if (m_bOnePass) {
+		return matchOnePass(pstrData);
+	}
+
+	const unsigned char* pData = (const unsigned char*)pstrData->data();
+	size_t len = pstrData->length();
+
+	threadList* pCurrent = &m_lists[0];
+	threadList* pNext = &m_lists[1];
+	pCurrent->count = 0;
+	bool bMatched = false;
+
+	nextGeneration();
+	for (size_t pos=0; ; pos++) {
+		if (!bMatched && (pos == 0 || !m_bAnchored)) {
+			if (pCurrent->count == 0 && m_strPrefix.length()) {
+				pos = findText((const char*)pData, len, pos, m_strPrefix.data(), m_strPrefix.length());
+				if (pos == string::npos) {
+					break;
+				}
+			}
+			addThread(pCurrent, 0, &m_vecStartCaps[0], pos, len);
+		}
+		if (pCurrent->count == 0) {
+			break;
+		}
+
+		nextGeneration();
+		pNext->count = 0;
+		for (size_t i=0; i<pCurrent->count; i++) {
+			u_int32_t pc = pCurrent->vecPCs[i];
+			const regexInstr& instr = m_vecProgram[pc];
+			size_t* pCaps = &pCurrent->vecCaps[i * m_uiSlots];
+
+			bool bStep = false;
+			switch (instr.uiOp) {
+				case REGEX_OP_CHAR:
+					bStep = (pos < len && pData[pos] == instr.ch);
+					break;
+				case REGEX_OP_CLASS:
+					bStep = (pos < len && m_vecClasses[instr.x][pData[pos]]);
+					break;
+				case REGEX_OP_ANY:
+					bStep = (pos < len);
+					break;
+				case REGEX_OP_MATCH:
+					// Lower priority threads can no longer produce the preferred match
+					copy(pCaps, pCaps + m_uiSlots, m_vecMatchCaps.begin());
+					bMatched = true;
+					i = pCurrent->count;
+					break;
+			}
+			if (bStep) {
+				addThread(pNext, pc + 1, pCaps, pos + 1, len);
+			}
+		}
+		swap(pCurrent, pNext);
+
+		if (pos >= len) {
+			break;
+		}
+	}
+
+	return bMatched;
+}
+
+textSpan regexMatcher::getCapture(size_t i) const {
+	textSpan span = { 0, 0 };
+	size_t posStart = m_vecMatchCaps[i * 2];
+	size_t posEnd = m_vecMatchCaps[i * 2 + 1];
+	if (posStart != string::npos && posEnd != string::npos && posEnd > posStart) {
+		span.pos = posStart;
+		span.len = posEnd - posStart;
+	}
+	return span;
+}
+
+void processRegex(string* pstrData, regexMatcher* pMatcher, const string& strTimeLayout, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
+	DEBUG("processRegex()");
+
+	if (pMatcher->match(pstrData)) {
+		// Time columns first, so rows outside --start/--end skip the remaining extraction
+		bool bTimed = false;
+		for (size_t i=0; i<pMatcher->getCaptureCount(); i++) {
+			int iColumn = pMatcher->getCaptureColumn(i);
+			if (iColumn >= MULTI2MAC_ATIME) {
+				string strTime = getSpanString(pstrData, pMatcher->getCapture(i));
+				int32_t timeVal = -1;
+				if (strTime.length()) {
+					if (strTimeLayout.length() && strTimeLayout != "epoch") {
+						timeVal = getUnix32FromLayout(strTime, strTimeLayout, uiSkew, pTZCalc);
+					} else {
+						timeVal = strtol(strTime.c_str(), NULL, 10) + uiSkew;
+					}
+				}
+				strFields[iColumn] = (timeVal > 0 ? boost_lexical_cast_wrapper<string>(timeVal) : "");
+				bTimed = true;
+			}
+		}
+		if (bTimed && !rowInTimeWindow(strFields)) {
+			for (int i=MULTI2MAC_ATIME; i<=MULTI2MAC_BTIME; i++) {
+				strFields[i].clear();
+			}
+			return;
+		}
+
+		strFields[MULTI2MAC_LOG] = "-------regex";
+		for (size_t i=0; i<pMatcher->getCaptureCount(); i++) {
+			int iColumn = pMatcher->getCaptureColumn(i);
+			if (iColumn < MULTI2MAC_ATIME) {
+				strFields[iColumn] = getSpanString(pstrData, pMatcher->getCapture(i));
+			}
+		}
+	} else {
+		DEBUG("processRegex() No match (" << *pstrData << ")");
+	}
+}
@@ -0,0 +1,149 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_REGEXMATCHER_H_
+#define MULTI2MACTIME_REGEXMATCHER_H_
+
+#include <string>
+#include <vector>
+#include <bitset>
+using namespace std;
+
+#include "processor.h"
+
+// Regular expression parser (--type regex --custom1 <pattern> [--custom2 <time layout>]). Named groups map directly
+// onto the multi2mactime columns:
+//
+//		(?<DETAIL>...) (?<TYPE>...) (?<FROM>...) (?<ATIME>...) ...		(?P<NAME>...) is also accepted
+//
+// Time columns are converted with the --custom2 layout (timeZoneCalculator::createLocalTime() syntax), or treated as
+// Unix times when --custom2 is not given or is "epoch". LOG defaults to "-------regex". Lines that do not match are
+// dropped.
+//
+// Patterns are compiled to a Thompson NFA and run as a Pike VM: all alternatives advance together one byte at a time,
+// so matching is linear in the length of the line regardless of the pattern; there is no backtracking. A literal
+// prefix, when the pattern has one, is used to skip ahead with findText() while no match is in progress.
+//
+// Most log patterns are anchored (^...) and "one-pass": at every point the next byte decides which alternative
+// continues, e.g. "^(?<DETAIL>\S+) (?<SIZE>\d+)$". Those are additionally compiled into a DFA whose transitions
+// carry the capture positions to record, so a line is matched with one table lookup per byte. Patterns that do not
+// qualify run on the Pike VM with identical results.
+//
+// Supported syntax: literals, '.', [...] / [^...] classes with ranges, \d \w \s \D \W \S \t \r \n and escaped
+// punctuation, (?:...) and named groups, '|', greedy and lazy * + ? {n} {n,} {n,m}, and the anchors ^ and $. Plain
+// (...) groups do not capture. Leftmost-first (Perl-style) submatch rules apply.
+
+#define REGEX_OP_CHAR		1
+#define REGEX_OP_CLASS		2
+#define REGEX_OP_ANY			3
+#define REGEX_OP_SPLIT		4
+#define REGEX_OP_JMP			5
+#define REGEX_OP_SAVE		6
+#define REGEX_OP_BOL			7
+#define REGEX_OP_EOL			8
+#define REGEX_OP_MATCH		9
+
+#define REGEX_MAX_PROGRAM	65536
+#define REGEX_MAX_ONEPASS	4096		// DFA states; larger patterns use the Pike VM
+
+#define REGEX_MATCH_NONE		0
+#define REGEX_MATCH_ALWAYS		1
+#define REGEX_MATCH_AT_END		2
+
+struct regexInstr {
+	u_int8_t uiOp;
+	u_int8_t ch;
+	u_int32_t x;			// CLASS index, SAVE slot, or JMP/SPLIT target (preferred)
+	u_int32_t y;			// SPLIT alternate target
+};
+
+class regexMatcher {
+	public:
+		regexMatcher();
+
+		bool compile(const string& strPattern);
+		size_t getCaptureCount() const { return m_vecCaptureColumns.size(); }
+		int getCaptureColumn(size_t i) const { return m_vecCaptureColumns[i]; }
+
+		// Searches the line for the leftmost match; getCapture() then returns the span of each named group (unset
+		// groups are {0,0}).
+		bool match(const string* pstrData);
+		textSpan getCapture(size_t i) const;
+
+	private:
+		struct onePassTransition {
+			int32_t iNext;
+			u_int32_t uiSaves;	// capture slots set to the current position before consuming the byte
+		};
+		struct onePassState {
+			u_int32_t pc;
+			int iMatch;
+			u_int32_t uiMatchSaves;
+		};
+		struct threadList {
+			vector<u_int32_t> vecPCs;
+			vector<size_t> vecCaps;
+			size_t count;
+		};
+
+		bool parseAlternation();
+		bool parseConcatenation();
+		bool parseRepetition();
+		bool parseAtom();
+		bool parseClass(bitset<256>* pClass);
+		bool parseEscape(int* pChar, bitset<256>* pClass);
+		bool parseCount(size_t* pCount);
+
+		void emit(u_int8_t uiOp, u_int8_t ch = 0, u_int32_t x = 0, u_int32_t y = 0);
+		void insert(size_t pos, const regexInstr& instr);
+		void appendFragment(const vector<regexInstr>& vecFragment, size_t posOrigin);
+		void emitStar(size_t posStart, bool bGreedy);
+		void emitOptional(size_t posStart, bool bGreedy);
+
+		bool compileOnePass();
+		bool onePassClosure(u_int32_t uiState, u_int32_t pc, u_int32_t uiSaves, bool* pbCut);
+		int32_t getOnePassState(u_int32_t pc);
+		bool matchOnePass(const string* pstrData);
+
+		void nextGeneration();
+		void addThread(threadList* pList, u_int32_t pc, size_t* pCaps, size_t pos, size_t len);
+
+		string m_strPattern;
+		size_t m_posPattern;
+		string m_strError;
+
+		vector<regexInstr> m_vecProgram;
+		vector<bitset<256> > m_vecClasses;
+		vector<int> m_vecCaptureColumns;
+		size_t m_uiSlots;
+		bool m_bAnchored;
+		string m_strPrefix;
+
+		bool m_bOnePass;
+		vector<onePassTransition> m_vecOnePass;	// 256 transitions per state
+		vector<onePassState> m_vecOnePassStates;
+		vector<int32_t> m_vecOnePassIndex;			// pc -> state
+
+		// Per-line scratch space, kept between calls to avoid reallocating
+		threadList m_lists[2];
+		vector<u_int32_t> m_vecSeen;
+		u_int32_t m_uiGeneration;
+		vector<size_t> m_vecStartCaps;
+		vector<size_t> m_vecMatchCaps;
+		vector<size_t> m_vecThreadCaps;
+};
+
+void processRegex(string* pstrData, regexMatcher* pMatcher, const string& strTimeLayout, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields);
+
+#endif /*MULTI2MACTIME_REGEXMATCHER_H_*/
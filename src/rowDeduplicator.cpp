@@ -0,0 +1,96 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "rowDeduplicator.h"
+#include "processor.h"
+
+#include <string>
+#include <cstring>
+using namespace std;
+
+#define ROWDEDUPLICATOR_MULTIPLIER	0xc6a4a7935bd1e995ULL
+
+// MurmurHash64A-style mixing, eight bytes at a time; uiHash carries the state from column to column.
+static u_int64_t hashBytes(const char* pData, size_t uiLength, u_int64_t uiHash) {
+	uiHash ^= uiLength * ROWDEDUPLICATOR_MULTIPLIER;
+
+	const char* pEnd = pData + (uiLength & ~(size_t)7);
+	for (; pData < pEnd; pData += 8) {
+		u_int64_t k;
+		memcpy(&k, pData, 8);
+		k *= ROWDEDUPLICATOR_MULTIPLIER;
+		k ^= k >> 47;
+		k *= ROWDEDUPLICATOR_MULTIPLIER;
+		uiHash ^= k;
+		uiHash *= ROWDEDUPLICATOR_MULTIPLIER;
+	}
+
+	u_int64_t k = 0;
+	for (size_t i=0; i<(uiLength & 7); i++) {
+		k |= (u_int64_t)(unsigned char)pData[i] << (i * 8);
+	}
+	uiHash ^= k;
+	uiHash *= ROWDEDUPLICATOR_MULTIPLIER;
+	uiHash ^= uiHash >> 47;
+	return uiHash;
+}
+
+rowDeduplicator::rowDeduplicator(u_int32_t uiHorizon) : m_uiLatest(0), m_uiOutside(0), m_uiDuplicates(0) {
+	m_uiBucketWidth = (uiHorizon >= ROWDEDUPLICATOR_BUCKETS ? uiHorizon / ROWDEDUPLICATOR_BUCKETS : 1);
+}
+
+bool rowDeduplicator::isDuplicate(const string* strFields) {
+	u_int32_t uiTime = getBodyRowTime(strFields);
+	if (!uiTime) {
+		return false;
+	}
+
+	// Lengths are mixed in per column, so moving text from one column to the next changes the hash
+	u_int64_t uiHash = 0;
+	for (int i=MULTI2MAC_HASH; i<=MULTI2MAC_BTIME; i++) {
+		uiHash = hashBytes(strFields[i].data(), strFields[i].length(), uiHash);
+	}
+
+	u_int32_t uiBucket = uiTime / m_uiBucketWidth;
+	u_int32_t uiLatestBucket = m_uiLatest / m_uiBucketWidth;
+	if (m_uiLatest && (uiBucket + ROWDEDUPLICATOR_BUCKETS < uiLatestBucket || uiBucket > uiLatestBucket + ROWDEDUPLICATOR_BUCKETS * ROWDEDUPLICATOR_MAX_LEAP)) {
+		// Behind the horizon (nothing to compare against) or too far ahead to trust, unless the input has moved on
+		if (++m_uiOutside < ROWDEDUPLICATOR_RESYNC_ROWS) {
+			return false;
+		}
+		DEBUG("rowDeduplicator::isDuplicate() Restarting at " << uiTime << " (was " << m_uiLatest << ")");
+		m_mapBuckets.clear();
+		m_uiLatest = 0;
+	}
+	m_uiOutside = 0;
+	if (!m_mapBuckets[uiBucket].insert(uiHash).second) {
+		m_uiDuplicates++;
+		return true;
+	}
+
+	if (uiTime > m_uiLatest) {
+		m_uiLatest = uiTime;
+		u_int32_t uiOldest = m_uiLatest / m_uiBucketWidth;
+		uiOldest = (uiOldest > ROWDEDUPLICATOR_BUCKETS ? uiOldest - ROWDEDUPLICATOR_BUCKETS : 0);
+		while (!m_mapBuckets.empty() && m_mapBuckets.begin()->first < uiOldest) {
+			DEBUG("rowDeduplicator::isDuplicate() Dropping bucket " << m_mapBuckets.begin()->first << " (" << m_mapBuckets.begin()->second.size() << " rows)");
+			m_mapBuckets.erase(m_mapBuckets.begin());
+		}
+	}
+	return false;
+}
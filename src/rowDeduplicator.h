@@ -0,0 +1,59 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_ROWDEDUPLICATOR_H_
+#define MULTI2MACTIME_ROWDEDUPLICATOR_H_
+
+#include <string>
+#include <map>
+#include <unordered_set>
+using namespace std;
+
+// Drops output rows identical to one already output (--dedup), e.g. from overlapping log rotations or the same syslog
+// captured by two collectors. Each row is reduced to a 64-bit hash of all of its columns and remembered in a set for
+// the time bucket of getBodyRowTime(). Buckets more than the horizon behind the latest time seen are discarded, so
+// memory is bounded by the number of rows per horizon rather than by the size of the input; duplicates further apart
+// than the horizon (in input order relative to event time) are not detected.
+//
+// A row can move the latest time ahead by at most ROWDEDUPLICATOR_MAX_LEAP horizons, so a single bad or far-future
+// timestamp does not push every later row behind the horizon; rows outside that window are output without being
+// compared. Once ROWDEDUPLICATOR_RESYNC_ROWS consecutive rows fall outside it the input has moved on (e.g. to the next
+// of several files read one after another) and the window restarts at the current row, forgetting what came before.
+// Duplicates across sequentially read files whose times overlap are therefore only found with --merge-sorted, which
+// reads the inputs in time order.
+//
+// Rows without a time are always output. Two different rows with the same time could in principle share a hash; at
+// 64 bits that is not a practical concern for timeline data.
+
+#define ROWDEDUPLICATOR_DEFAULT_HORIZON	3600		// seconds
+#define ROWDEDUPLICATOR_BUCKETS				16			// per horizon
+#define ROWDEDUPLICATOR_MAX_LEAP				4			// horizons
+#define ROWDEDUPLICATOR_RESYNC_ROWS			64
+
+class rowDeduplicator {
+	public:
+		rowDeduplicator(u_int32_t uiHorizon = ROWDEDUPLICATOR_DEFAULT_HORIZON);
+
+		bool isDuplicate(const string* strFields);
+		u_int64_t getDuplicates() const { return m_uiDuplicates; }
+
+	private:
+		u_int32_t m_uiBucketWidth;
+		u_int32_t m_uiLatest;
+		u_int32_t m_uiOutside;						// consecutive rows outside the window
+		map<u_int32_t, unordered_set<u_int64_t> > m_mapBuckets;		// bucket number -> row hashes
+		u_int64_t m_uiDuplicates;
+};
+
+#endif /*MULTI2MACTIME_ROWDEDUPLICATOR_H_*/
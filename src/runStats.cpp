@@ -0,0 +1,200 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "runStats.h"
+#include "processor.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <ctime>
+using namespace std;
+
+runStats::runStats(string strType, const vector<string>& vecParsers) : m_strType(strType), m_vecParsers(vecParsers), m_dFileWallStart(0), m_dFileCPUStart(0) {
+	m_dWallStart = getClock(CLOCK_MONOTONIC);
+	m_dCPUStart = getClock(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+size_t runStats::addFile(string strFilename) {
+	rowCounters counters = { 0, 0, 0, 0, 0, 0 };
+	fileStats stats = { (strFilename != "" ? strFilename : "(stdin)"), vector<rowCounters>(m_vecParsers.size(), counters), 0.0, 0.0 };
+	m_vecFiles.push_back(stats);
+	return m_vecFiles.size() - 1;
+}
+
+void runStats::beginFile(size_t uiFile) {
+	m_dFileWallStart = getClock(CLOCK_MONOTONIC);
+	m_dFileCPUStart = getClock(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void runStats::endFile(size_t uiFile) {
+	m_vecFiles[uiFile].dWall += getClock(CLOCK_MONOTONIC) - m_dFileWallStart;
+	m_vecFiles[uiFile].dCPU += getClock(CLOCK_PROCESS_CPUTIME_ID) - m_dFileCPUStart;
+}
+
+runStats::rowCounters runStats::sumCounters(const vector<rowCounters>& vecCounters) {
+	rowCounters rv = { 0, 0, 0, 0, 0, 0 };
+	for (vector<rowCounters>::const_iterator it = vecCounters.begin(); it != vecCounters.end(); it++) {
+		rv.uiBytes += it->uiBytes;
+		rv.uiRows += it->uiRows;
+		rv.uiEmitted += it->uiEmitted;
+		rv.uiSecondary += it->uiSecondary;
+		rv.uiDropped += it->uiDropped;
+		rv.uiTimeFailures += it->uiTimeFailures;
+	}
+	return rv;
+}
+
+// Per parser sums over all files, with the run's times
+runStats::fileStats runStats::getTotals() const {
+	rowCounters counters = { 0, 0, 0, 0, 0, 0 };
+	fileStats rv = { "TOTAL", vector<rowCounters>(m_vecParsers.size(), counters), 0.0, 0.0 };
+	for (size_t i=0; i<m_vecParsers.size(); i++) {
+		vector<rowCounters> vecParser;
+		for (vector<fileStats>::const_iterator it = m_vecFiles.begin(); it != m_vecFiles.end(); it++) {
+			vecParser.push_back(it->vecParsers[i]);
+		}
+		rv.vecParsers[i] = sumCounters(vecParser);
+	}
+	rv.dWall = getClock(CLOCK_MONOTONIC) - m_dWallStart;
+	rv.dCPU = getClock(CLOCK_PROCESS_CPUTIME_ID) - m_dCPUStart;
+	return rv;
+}
+
+// The times are per file, so a parser's row leaves them blank
+void runStats::printTableRow(ostream* pOutput, string strName, const rowCounters& counters, const double* pdWall, const double* pdCPU) const {
+	strName = (strName.length() > 39 ? "..." + strName.substr(strName.length() - 36) : strName);
+	*pOutput << left << setw(40) << strName << right << setw(14) << counters.uiBytes << setw(12) << counters.uiRows << setw(12) << counters.uiEmitted << setw(12) << counters.uiSecondary
+				<< setw(10) << counters.uiDropped << setw(10) << counters.uiTimeFailures;
+	if (pdWall) {
+		*pOutput << fixed << setprecision(3) << setw(10) << *pdWall << setw(10) << *pdCPU
+					<< setprecision(1) << setw(10) << (*pdWall > 0 ? counters.uiBytes / *pdWall / 1e6 : 0.0);
+	}
+	*pOutput << "\n";
+}
+
+void runStats::printTable(ostream* pOutput) const {
+	vector<fileStats> vecRows(m_vecFiles);
+	vecRows.push_back(getTotals());
+
+	*pOutput << "stats (" << m_strType << "):\n";
+	*pOutput << left << setw(40) << "file" << right << setw(14) << "bytes" << setw(12) << "rows" << setw(12) << "emitted" << setw(12) << "secondary"
+				<< setw(10) << "dropped" << setw(10) << "time-err" << setw(10) << "wall-s" << setw(10) << "cpu-s" << setw(10) << "MB/s" << "\n";
+	for (vector<fileStats>::const_iterator it = vecRows.begin(); it != vecRows.end(); it++) {
+		printTableRow(pOutput, it->strFilename, sumCounters(it->vecParsers), &it->dWall, &it->dCPU);
+		if (m_vecParsers.size() > 1) {
+			for (size_t i=0; i<m_vecParsers.size(); i++) {
+				if (it->vecParsers[i].uiRows) {
+					printTableRow(pOutput, "  " + m_vecParsers[i], it->vecParsers[i], NULL, NULL);
+				}
+			}
+		}
+	}
+}
+
+void runStats::printJSONCounters(ostream* pOutput, const rowCounters& counters) const {
+	*pOutput << "\"bytes\": " << counters.uiBytes << ", \"rows\": " << counters.uiRows << ", \"emitted\": " << counters.uiEmitted << ", \"secondary\": " << counters.uiSecondary
+				<< ", \"dropped\": " << counters.uiDropped << ", \"time_failures\": " << counters.uiTimeFailures;
+}
+
+void runStats::printJSON(ostream* pOutput) const {
+	fileStats totals = getTotals();
+	*pOutput << "{\"type\": " << getQuoted(m_strType) << ", \"files\": [";
+	for (size_t i=0; i<=m_vecFiles.size(); i++) {
+		const fileStats& stats = (i < m_vecFiles.size() ? m_vecFiles[i] : totals);
+		if (i == m_vecFiles.size()) {
+			*pOutput << "], \"total\": ";
+		} else if (i) {
+			*pOutput << ", ";
+		}
+		*pOutput << "{";
+		if (i < m_vecFiles.size()) {
+			*pOutput << "\"file\": " << getQuoted(stats.strFilename) << ", ";
+		}
+		printJSONCounters(pOutput, sumCounters(stats.vecParsers));
+		*pOutput << fixed << setprecision(6) << ", \"wall_seconds\": " << stats.dWall << ", \"cpu_seconds\": " << stats.dCPU;
+		if (m_vecParsers.size() > 1) {
+			*pOutput << ", \"parsers\": {";
+			for (size_t j=0; j<m_vecParsers.size(); j++) {
+				*pOutput << (j ? ", " : "") << getQuoted(m_vecParsers[j]) << ": {";
+				printJSONCounters(pOutput, stats.vecParsers[j]);
+				*pOutput << "}";
+			}
+			*pOutput << "}";
+		}
+		*pOutput << "}";
+	}
+	*pOutput << "}\n";
+}
+
+bool runStats::writePrometheus(string strFilename) const {
+	ofstream fileOutput(strFilename.c_str());
+	if (!fileOutput) {
+		LOG_ERROR("runStats::writePrometheus() Unable to create " << strFilename);
+		return false;
+	}
+
+	struct metric {
+		const char* cstrName;
+		const char* cstrHelp;
+		u_int64_t rowCounters::*pCounter;
+		double fileStats::*pSeconds;
+	};
+	static const metric METRICS[] = {
+		{ "multi2mactime_bytes_read_total",			"Bytes of input read.",								&rowCounters::uiBytes,			NULL },
+		{ "multi2mactime_rows_read_total",			"Input lines read.",									&rowCounters::uiRows,			NULL },
+		{ "multi2mactime_rows_emitted_total",		"Primary rows output.",								&rowCounters::uiEmitted,		NULL },
+		{ "multi2mactime_secondary_rows_total",	"Secondary rows output.",							&rowCounters::uiSecondary,		NULL },
+		{ "multi2mactime_rows_dropped_total",		"Input lines that produced no DETAIL.",			&rowCounters::uiDropped,		NULL },
+		{ "multi2mactime_time_failures_total",		"Time values that could not be converted.",		&rowCounters::uiTimeFailures,	NULL },
+		{ "multi2mactime_wall_seconds",				"Wall time spent reading the input.",				NULL,									&fileStats::dWall },
+		{ "multi2mactime_cpu_seconds",				"Process CPU time spent reading the input.",	NULL,									&fileStats::dCPU },
+	};
+
+	// Per file (and parser) series only; the totals are a sum() away (except the times with --merge-sorted, which are
+	// run totals). Counters are labelled with the parser that handled the rows, times with the --type.
+	vector<fileStats> vecRows(m_vecFiles);
+	if (vecRows.empty()) {
+		vecRows.push_back(getTotals());
+	}
+	for (size_t i=0; i<sizeof(METRICS)/sizeof(METRICS[0]); i++) {
+		const metric& m = METRICS[i];
+		fileOutput << "# HELP " << m.cstrName << " " << m.cstrHelp << "\n";
+		fileOutput << "# TYPE " << m.cstrName << " " << (m.pCounter ? "counter" : "gauge") << "\n";
+		for (vector<fileStats>::const_iterator it = vecRows.begin(); it != vecRows.end(); it++) {
+			if (m.pCounter) {
+				for (size_t j=0; j<m_vecParsers.size(); j++) {
+					fileOutput << m.cstrName << "{type=" << getQuoted(m_vecParsers[j]) << ",file=" << getQuoted(it->strFilename) << "} " << it->vecParsers[j].*(m.pCounter) << "\n";
+				}
+			} else {
+				fileOutput << m.cstrName << "{type=" << getQuoted(m_strType) << ",file=" << getQuoted(it->strFilename) << "} " << fixed << setprecision(6) << (*it).*(m.pSeconds) << "\n";
+			}
+		}
+	}
+
+	fileOutput.close();
+	if (!fileOutput) {
+		LOG_ERROR("runStats::writePrometheus() Unable to write " << strFilename);
+		return false;
+	}
+	return true;
+}
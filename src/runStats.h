@@ -0,0 +1,88 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_RUNSTATS_H_
+#define MULTI2MACTIME_RUNSTATS_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+using namespace std;
+
+// Per input file counters for --stats, reported at exit as a table or JSON (stderr) and optionally as a Prometheus
+// text-format file. "Dropped" rows are lines for which the parser produced no DETAIL (unparseable, comments, or
+// outside a --start/--end window the parser already filtered on); time failures are conversions that failed while
+// parsing the file's rows (getTimeFailures()).
+//
+// The counters are kept per parser that handled the row. For a single --type that is the type itself; auto-syslog
+// passes one parser per device class, and each file is broken down by class.
+//
+// Wall and CPU time are measured between beginFile() and endFile(); with --merge-sorted the inputs are read
+// interleaved, so only the totals, which cover the whole run, carry times.
+
+class runStats {
+	public:
+		runStats(string strType, const vector<string>& vecParsers);
+
+		size_t addFile(string strFilename);
+		void beginFile(size_t uiFile);
+		void endFile(size_t uiFile);
+
+		void addRow(size_t uiFile, size_t uiParser, u_int64_t uiBytes, bool bDropped, u_int64_t uiTimeFailures) {
+			rowCounters& counters = m_vecFiles[uiFile].vecParsers[uiParser];
+			counters.uiBytes += uiBytes;
+			counters.uiRows++;
+			counters.uiDropped += bDropped;
+			counters.uiTimeFailures += uiTimeFailures;
+		}
+		void addEmitted(size_t uiFile, size_t uiParser, bool bSecondary) {
+			rowCounters& counters = m_vecFiles[uiFile].vecParsers[uiParser];
+			(bSecondary ? counters.uiSecondary : counters.uiEmitted)++;
+		}
+
+		void printTable(ostream* pOutput) const;
+		void printJSON(ostream* pOutput) const;
+		bool writePrometheus(string strFilename) const;
+
+	private:
+		struct rowCounters {
+			u_int64_t uiBytes;
+			u_int64_t uiRows;
+			u_int64_t uiEmitted;
+			u_int64_t uiSecondary;
+			u_int64_t uiDropped;
+			u_int64_t uiTimeFailures;
+		};
+		struct fileStats {
+			string strFilename;
+			vector<rowCounters> vecParsers;		// indexed as m_vecParsers
+			double dWall;
+			double dCPU;
+		};
+
+		static rowCounters sumCounters(const vector<rowCounters>& vecCounters);
+		fileStats getTotals() const;
+		void printTableRow(ostream* pOutput, string strName, const rowCounters& counters, const double* pdWall, const double* pdCPU) const;
+		void printJSONCounters(ostream* pOutput, const rowCounters& counters) const;
+
+		string m_strType;
+		vector<string> m_vecParsers;
+		vector<fileStats> m_vecFiles;
+		double m_dWallStart;						// of the run
+		double m_dCPUStart;
+		double m_dFileWallStart;					// of the file between beginFile() and endFile()
+		double m_dFileCPUStart;
+};
+
+#endif /*MULTI2MACTIME_RUNSTATS_H_*/
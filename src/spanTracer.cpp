@@ -0,0 +1,174 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "spanTracer.h"
+#include "processor.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+using namespace std;
+
+#define SPANTRACER_IO_BUFFER	(1024 * 1024)
+
+bool bTraceEnabled = false;
+
+static FILE* pTraceFile = NULL;
+static mutex mutexTrace;
+static u_int64_t uiTraceStart = 0;
+static bool bTraceFirst = true;
+static string strTraceParse;					// "parse <type>"
+static atomic<int> iTraceThreads(0);
+static thread_local int iTraceThread = 0;
+static int iTraceBatchThread = 0;				// track of the row batches
+
+// Row batch state (main thread)
+static u_int64_t uiBatchStart = 0;
+static u_int64_t uiBatchStages[SPANTRACER_STAGES];
+static u_int64_t uiBatchRows = 0;
+static u_int64_t uiBatchFirstRow = 0;
+static string strBatchFile;
+
+static int getTraceThread() {
+	if (!iTraceThread) {
+		iTraceThread = ++iTraceThreads;
+	}
+	return iTraceThread;
+}
+
+// Caller holds mutexTrace
+static void writeEvent(const string& strEvent) {
+	fputs(bTraceFirst ? "\n" : ",\n", pTraceFile);
+	fputs(strEvent.c_str(), pTraceFile);
+	bTraceFirst = false;
+}
+
+static void writeSpan(const string& strName, int iThread, u_int64_t uiStart, u_int64_t uiEnd, const string& strArgs) {
+	char cstrTimes[96];
+	snprintf(cstrTimes, sizeof(cstrTimes), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", iThread, (uiStart - uiTraceStart) / 1000.0, (uiEnd - uiStart) / 1000.0);
+	writeEvent("{\"name\":" + getQuoted(strName) + cstrTimes + (strArgs.length() ? ",\"args\":{" + strArgs + "}" : "") + "}");
+}
+
+bool traceOpen(string strFilename, string strType) {
+	pTraceFile = fopen(strFilename.c_str(), "w");
+	if (!pTraceFile) {
+		LOG_ERROR("traceOpen() Unable to create " << strFilename);
+		return false;
+	}
+	setvbuf(pTraceFile, NULL, _IOFBF, SPANTRACER_IO_BUFFER);
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", pTraceFile);
+
+	uiTraceStart = getTraceClock();
+	strTraceParse = "parse " + strType;
+	bTraceEnabled = true;
+
+	lock_guard<mutex> lock(mutexTrace);
+	writeEvent("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"multi2mactime\"}}");
+	iTraceThread = 0;
+	char cstrEvent[128];
+	snprintf(cstrEvent, sizeof(cstrEvent), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"main\"}}", getTraceThread());
+	writeEvent(cstrEvent);
+	iTraceBatchThread = ++iTraceThreads;
+	snprintf(cstrEvent, sizeof(cstrEvent), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"main (row batches)\"}}", iTraceBatchThread);
+	writeEvent(cstrEvent);
+	return true;
+}
+
+// Any other thread recording spans must have stopped (e.g. compressedOutput::close()) before this.
+bool traceClose() {
+	if (!pTraceFile) {
+		return false;
+	}
+	bTraceEnabled = false;
+	fputs("\n]}\n", pTraceFile);
+	bool rv = (fclose(pTraceFile) == 0);
+	if (!rv) {
+		LOG_ERROR("traceClose() Unable to write the trace file");
+	}
+	pTraceFile = NULL;
+	return rv;
+}
+
+void traceSetThreadName(const char* cstrName) {
+	if (!isTracing()) {
+		return;
+	}
+	lock_guard<mutex> lock(mutexTrace);
+	writeEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + to_string(getTraceThread()) + ",\"args\":{\"name\":" + getQuoted(cstrName) + "}}");
+}
+
+void traceAddSpan(const char* cstrName, u_int64_t uiStart, u_int64_t uiEnd, const string& strDetail) {
+	if (!isTracing()) {
+		return;
+	}
+	lock_guard<mutex> lock(mutexTrace);
+	writeSpan(cstrName, getTraceThread(), uiStart, uiEnd, (strDetail.length() ? "\"detail\":" + getQuoted(strDetail) : ""));
+}
+
+void traceAddStage(int iStage, u_int64_t uiNanos) {
+	uiBatchStages[iStage] += uiNanos;
+}
+
+void traceBeginBatch(const string& strFilename) {
+	if (!isTracing()) {
+		return;
+	}
+	uiBatchStart = getTraceClock();
+	for (int i=0; i<SPANTRACER_STAGES; i++) {
+		uiBatchStages[i] = 0;
+	}
+	uiBatchRows = 0;
+	uiBatchFirstRow = 0;
+	strBatchFile = (strFilename != "" ? strFilename : "(stdin)");
+}
+
+void traceEndRow() {
+	if (isTracing() && ++uiBatchRows == SPANTRACER_BATCH_ROWS) {
+		traceEndBatch();
+	}
+}
+
+// Emits the batch and its stages, then starts the next batch of the same file
+void traceEndBatch() {
+	if (!isTracing() || !uiBatchRows) {
+		return;
+	}
+	u_int64_t uiEnd = getTraceClock();
+	u_int64_t uiParse = uiBatchStages[SPANTRACER_STAGE_PARSE];
+	u_int64_t uiTime = min(uiBatchStages[SPANTRACER_STAGE_TIME], uiParse);
+	u_int64_t uiOutput = uiBatchStages[SPANTRACER_STAGE_OUTPUT];
+	u_int64_t uiRead = uiEnd - uiBatchStart - min(uiParse + uiOutput, uiEnd - uiBatchStart);
+	{
+		lock_guard<mutex> lock(mutexTrace);
+		writeSpan("batch", iTraceBatchThread, uiBatchStart, uiEnd, "\"file\":" + getQuoted(strBatchFile) + ",\"first_row\":" + to_string(uiBatchFirstRow) + ",\"rows\":" + to_string(uiBatchRows));
+		writeSpan(strTraceParse, iTraceBatchThread, uiBatchStart, uiBatchStart + uiParse, "");
+		writeSpan("time conversion", iTraceBatchThread, uiBatchStart, uiBatchStart + uiTime, "");
+		writeSpan("output", iTraceBatchThread, uiBatchStart + uiParse, uiBatchStart + uiParse + uiOutput, "");
+		writeSpan("read", iTraceBatchThread, uiBatchStart + uiParse + uiOutput, uiBatchStart + uiParse + uiOutput + uiRead, "");
+	}
+
+	uiBatchStart = uiEnd;
+	for (int i=0; i<SPANTRACER_STAGES; i++) {
+		uiBatchStages[i] = 0;
+	}
+	uiBatchFirstRow += uiBatchRows;
+	uiBatchRows = 0;
+}
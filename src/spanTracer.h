@@ -0,0 +1,105 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_SPANTRACER_H_
+#define MULTI2MACTIME_SPANTRACER_H_
+
+#include <string>
+#include <ctime>
+using namespace std;
+
+// Timed spans of the processing pipeline (--trace), written as Chrome trace-event JSON for chrome://tracing or
+// https://ui.perfetto.dev. When tracing is off every hook is a single test of a global flag.
+//
+// Coarse work (opening/seeking a file, sorter spills and merges, compressing and writing output blocks, database
+// commits, the final flush) is recorded as real spans on the thread that did it. Per row work is far too fine to record
+// individually, so rows are traced in batches of SPANTRACER_BATCH_ROWS: the time spent in each stage is summed over
+// the batch and drawn as back to back child spans of a "batch" span ("parse <type>", containing "time conversion",
+// then "output" and "read") on a separate "main (row batches)" track, since the stage totals do not line up with the
+// real spans on the main thread. "read" is what remains of the batch after the other stages: reading lines plus the
+// loop's own bookkeeping. A batch that takes longer than its neighbours, or a stage that dominates it, is the stall.
+
+#define SPANTRACER_STAGE_PARSE		0			// processRow(), including time conversion
+#define SPANTRACER_STAGE_TIME			1			// timestamp helpers and createLocalTime()
+#define SPANTRACER_STAGE_OUTPUT		2			// outputRow()
+#define SPANTRACER_STAGES				3
+
+#define SPANTRACER_BATCH_ROWS			4096
+
+extern bool bTraceEnabled;
+
+inline bool isTracing() {
+	return bTraceEnabled;
+}
+
+inline u_int64_t getTraceClock() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u_int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+bool traceOpen(string strFilename, string strType);
+bool traceClose();
+void traceSetThreadName(const char* cstrName);
+void traceAddSpan(const char* cstrName, u_int64_t uiStart, u_int64_t uiEnd, const string& strDetail = "");
+
+// Row batches; main thread only
+void traceAddStage(int iStage, u_int64_t uiNanos);
+void traceBeginBatch(const string& strFilename);
+void traceEndRow();
+void traceEndBatch();
+
+// Records a span from construction to destruction
+class traceSpan {
+	public:
+		traceSpan(const char* cstrName, const string& strDetail = "") : m_cstrName(cstrName), m_uiStart(isTracing() ? getTraceClock() : 0) {
+			if (m_uiStart) {
+				m_strDetail = strDetail;
+			}
+		}
+		~traceSpan() {
+			if (m_uiStart) {
+				traceAddSpan(m_cstrName, m_uiStart, getTraceClock(), m_strDetail);
+			}
+		}
+
+	private:
+		traceSpan(const traceSpan&);
+		traceSpan& operator=(const traceSpan&);
+
+		const char* m_cstrName;
+		u_int64_t m_uiStart;
+		string m_strDetail;
+};
+
+// Adds the time from construction to destruction to a stage of the current row batch
+class traceStage {
+	public:
+		traceStage(int iStage) : m_iStage(iStage), m_uiStart(isTracing() ? getTraceClock() : 0) {
+		}
+		~traceStage() {
+			if (m_uiStart) {
+				traceAddStage(m_iStage, getTraceClock() - m_uiStart);
+			}
+		}
+
+	private:
+		traceStage(const traceStage&);
+		traceStage& operator=(const traceStage&);
+
+		int m_iStage;
+		u_int64_t m_uiStart;
+};
+
+#endif /*MULTI2MACTIME_SPANTRACER_H_*/
@@ -0,0 +1,164 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "sqliteWriter.h"
+#include "processor.h"
+#include "spanTracer.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <cstdlib>
+#ifdef HAVE_SQLITE3
+#include <sqlite3.h>
+#endif
+using namespace std;
+
+bool sqliteWriter::isAvailable() {
+#ifdef HAVE_SQLITE3
+	return true;
+#else
+	return false;
+#endif
+}
+
+#ifdef HAVE_SQLITE3
+
+sqliteWriter::sqliteWriter() : m_pDB(NULL), m_pInsert(NULL), m_uiRows(0) {
+}
+
+sqliteWriter::~sqliteWriter() {
+	if (m_pInsert) {
+		sqlite3_finalize(m_pInsert);
+	}
+	if (m_pDB) {
+		sqlite3_close(m_pDB);
+	}
+}
+
+bool sqliteWriter::exec(const char* cstrSQL) {
+	char* cstrError = NULL;
+	if (sqlite3_exec(m_pDB, cstrSQL, NULL, NULL, &cstrError) != SQLITE_OK) {
+		LOG_ERROR("sqliteWriter::exec() " << m_strFilename << ": " << (cstrError ? cstrError : "unknown error") << " (" << cstrSQL << ")");
+		sqlite3_free(cstrError);
+		return false;
+	}
+	return true;
+}
+
+bool sqliteWriter::open(string strFilename) {
+	m_strFilename = strFilename;
+	if (sqlite3_open(strFilename.c_str(), &m_pDB) != SQLITE_OK) {
+		LOG_ERROR("sqliteWriter::open() Unable to open " << strFilename << ": " << sqlite3_errmsg(m_pDB));
+		return false;
+	}
+
+	if (!exec("PRAGMA journal_mode = OFF; PRAGMA synchronous = OFF; PRAGMA locking_mode = EXCLUSIVE; PRAGMA temp_store = MEMORY; PRAGMA cache_size = -262144;") ||
+			!exec("CREATE TABLE IF NOT EXISTS timeline (hash TEXT, detail TEXT, type TEXT, log_src TEXT, from_addr TEXT, to_addr TEXT, size TEXT, "
+					"atime INTEGER, mtime INTEGER, ctime INTEGER, btime INTEGER, time INTEGER);") ||
+			!exec("BEGIN;")) {
+		return false;
+	}
+
+	if (sqlite3_prepare_v2(m_pDB, "INSERT INTO timeline VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);", -1, &m_pInsert, NULL) != SQLITE_OK) {
+		LOG_ERROR("sqliteWriter::open() " << strFilename << ": " << sqlite3_errmsg(m_pDB));
+		return false;
+	}
+	return true;
+}
+
+bool sqliteWriter::add(const string* strFields) {
+	if (!m_pInsert) {
+		return false;
+	}
+
+	// Text is bound SQLITE_STATIC; the fields outlive the sqlite3_step() below
+	for (int i=MULTI2MAC_HASH; i<=MULTI2MAC_BTIME; i++) {
+		if (i < MULTI2MAC_ATIME) {
+			sqlite3_bind_text(m_pInsert, i + 1, strFields[i].data(), strFields[i].length(), SQLITE_STATIC);
+		} else if (strFields[i].length()) {
+			sqlite3_bind_int64(m_pInsert, i + 1, strtoll(strFields[i].c_str(), NULL, 10));
+		} else {
+			sqlite3_bind_null(m_pInsert, i + 1);
+		}
+	}
+	u_int32_t uiTime = getBodyRowTime(strFields);
+	if (uiTime) {
+		sqlite3_bind_int64(m_pInsert, MULTI2MAC_BTIME + 2, uiTime);
+	} else {
+		sqlite3_bind_null(m_pInsert, MULTI2MAC_BTIME + 2);
+	}
+
+	bool rv = (sqlite3_step(m_pInsert) == SQLITE_DONE);
+	if (!rv) {
+		LOG_ERROR("sqliteWriter::add() " << m_strFilename << ": " << sqlite3_errmsg(m_pDB));
+	}
+	sqlite3_reset(m_pInsert);
+
+	if (rv && ++m_uiRows % SQLITEWRITER_TRANSACTION_ROWS == 0) {
+		traceSpan span("commit");
+		rv = exec("COMMIT; BEGIN;");
+	}
+	return rv;
+}
+
+bool sqliteWriter::close() {
+	if (!m_pDB) {
+		return false;
+	}
+
+	bool rv = (m_pInsert != NULL);
+	if (m_pInsert) {
+		sqlite3_finalize(m_pInsert);
+		m_pInsert = NULL;
+	}
+
+	DEBUG("sqliteWriter::close() Indexing " << m_uiRows << " rows");
+	rv = rv && exec("COMMIT;") &&
+			exec("CREATE INDEX IF NOT EXISTS timeline_time ON timeline (time); CREATE INDEX IF NOT EXISTS timeline_log_src ON timeline (log_src);");
+
+	if (sqlite3_close(m_pDB) != SQLITE_OK) {
+		LOG_ERROR("sqliteWriter::close() " << m_strFilename << ": " << sqlite3_errmsg(m_pDB));
+		rv = false;
+	}
+	m_pDB = NULL;
+	return rv;
+}
+
+#else
+
+// Built without sqlite3; --output sqlite: is rejected before a writer is created
+sqliteWriter::sqliteWriter() : m_pDB(NULL), m_pInsert(NULL), m_uiRows(0) {
+}
+
+sqliteWriter::~sqliteWriter() {
+}
+
+bool sqliteWriter::open(string strFilename) {
+	LOG_ERROR("sqliteWriter::open() Built without sqlite3 (" << strFilename << ")");
+	return false;
+}
+
+bool sqliteWriter::add(const string* strFields) {
+	return false;
+}
+
+bool sqliteWriter::close() {
+	return false;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_SQLITEWRITER_H_
+#define MULTI2MACTIME_SQLITEWRITER_H_
+
+#include <string>
+using namespace std;
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+// Loads output rows into a SQLite database (--output sqlite:<path>), appending to the timeline table if it exists:
+//
+//	timeline(hash, detail, type, log_src, from_addr, to_addr, size, atime, mtime, ctime, btime, time)
+//
+// Time columns are integers (NULL when empty) and time is the row's getBodyRowTime(). Rows are inserted through one
+// prepared statement in transactions of SQLITEWRITER_TRANSACTION_ROWS rows, with the journal and syncing turned off for
+// the load; the database is only guaranteed to be intact once close() succeeds. The indexes on time and log_src are
+// created by close(), after the load, instead of being maintained row by row.
+//
+// sqlite3 is optional; without it (HAVE_SQLITE3 undefined) isAvailable() is false and --output sqlite: is rejected.
+
+#define SQLITEWRITER_TRANSACTION_ROWS	250000
+
+class sqliteWriter {
+	public:
+		sqliteWriter();
+		~sqliteWriter();
+
+		static bool isAvailable();
+
+		bool open(string strFilename);
+		bool add(const string* strFields);
+		bool close();
+
+	private:
+		sqliteWriter(const sqliteWriter&);
+		sqliteWriter& operator=(const sqliteWriter&);
+
+		bool exec(const char* cstrSQL);
+
+		sqlite3* m_pDB;
+		sqlite3_stmt* m_pInsert;
+		string m_strFilename;
+		u_int64_t m_uiRows;
+};
+
+#endif /*MULTI2MACTIME_SQLITEWRITER_H_*/
@@ -17,8 +17,11 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "textSearch.h"
+#include "keyScanner.h"
 
 #include <string>
+#include <cstdlib>
 using namespace std;
 
 #include "libtimeUtils/src/timeZoneCalculator.h"
@@ -27,6 +30,35 @@ using namespace std;
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
+#define SQUID_KEY_CIP		0
+#define SQUID_KEY_CSIP		1
+#define SQUID_KEY_CPORT		2
+#define SQUID_KEY_RIP		3
+#define SQUID_KEY_RPORT		4
+#define SQUID_KEY_BYTES		5
+#define SQUID_KEY_METHOD	6
+#define SQUID_KEY_URI		7
+#define SQUID_KEY_REFERER	8
+#define SQUID_KEY_COUNT		9
+
+static const keyDefinition SQUID_KEYS[SQUID_KEY_COUNT] = {
+	{" c_ip=",			" "},
+	{" cs_ip=",			" "},
+	{" c_port=",		" "},
+	{" r_ip=",			" "},
+	{" r_port=",		" "},
+	{" sc_bytes=",		" "},
+	{" cs_method=",	" "},
+	{" c_uri=",			" "},
+	{" referer=",		" "},
+};
+static const keyScanner squidKeys(SQUID_KEYS, SQUID_KEY_COUNT);
+
+int32_t getSquidW3cTime(const string* pstrData, u_int32_t uiSkew, timeZoneCalculator* pTZCalc) {
+	// Leading Unix time; output as-is (no skew) by processSquidW3c()
+	return strtol(pstrData->c_str(), NULL, 10);
+}
+
 void processSquidW3c(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, string* strSecondary) {
 	DEBUG("processSquidW3c()" << "[" << *pstrData << "]");
 	// Squid has their own log format, but allow custom log formats; this one
@@ -55,20 +87,26 @@ void processSquidW3c(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool
 
 	//TODO - This is a problem... some of these logs files come with the log file included in the data; others do not. Need a more robust way to handle both options.
 	// string strTime = 		findSubString(*pstrData, 0, "", ".");
-	string strTime = 		findSubString(*pstrData, 0, "", ".");
+	string strTime = 		getSpanString(pstrData, findTextSpan(pstrData, 0, "", "."));
 	DEBUG(strTime);
+	if (!inTimeWindow(getSquidW3cTime(pstrData, uiSkew, pTZCalc))) {
+		return;
+	}
 	
-	string strSrc = 		findSubString(*pstrData, 0, " c_ip=", " ") +
-								"/" + findSubString(*pstrData, 0, " cs_ip=", " ") + ":" +
-								findSubString(*pstrData, 0, " c_port=", " ");
+	textSpan spans[SQUID_KEY_COUNT];
+	squidKeys.scan(pstrData, 0, spans);
+
+	string strSrc = 		getSpanString(pstrData, spans[SQUID_KEY_CIP]) +
+								"/" + getSpanString(pstrData, spans[SQUID_KEY_CSIP]) + ":" +
+								getSpanString(pstrData, spans[SQUID_KEY_CPORT]);
 
-	string strDst =		findSubString(*pstrData, 0, " r_ip=", " ") + ":" +
-								findSubString(*pstrData, 0, " r_port=", " ");
+	string strDst =		getSpanString(pstrData, spans[SQUID_KEY_RIP]) + ":" +
+								getSpanString(pstrData, spans[SQUID_KEY_RPORT]);
 
-	string strBytes = 	findSubString(*pstrData, 0, " sc_bytes=", " ");
+	string strBytes = 	getSpanString(pstrData, spans[SQUID_KEY_BYTES]);
 
-	string strMethod =	findSubString(*pstrData, 0, " cs_method=", " ");
-	string strURI = 		findSubString(*pstrData, 0, " c_uri=", " "); 
+	string strMethod =	getSpanString(pstrData, spans[SQUID_KEY_METHOD]);
+	string strURI = 		getSpanString(pstrData, spans[SQUID_KEY_URI]);
 	string strName = 		strMethod + " " + strURI;
 
 	if (bNormalize) {
@@ -90,7 +128,7 @@ void processSquidW3c(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool
 	//strFields[MULTI2MAC_BTIME]	= 
 	
 	//Find and passback the referal URL as a second entry for the timeline.
-	string strURI2 = 		findSubString(*pstrData, 0, " referer=", " ");
+	string strURI2 = 		getSpanString(pstrData, spans[SQUID_KEY_REFERER]);
 	// Check to make sure referal URL is valid/useful before adding it to the timeline.
 	if (strURI2 != "\"-\"") {
 		string strName2 = 	"REFERER " + strURI2;
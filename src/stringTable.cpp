@@ -0,0 +1,114 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "stringTable.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+#define STRINGTABLE_INITIAL_SLOTS	64			// power of two
+
+// FNV-1a; values are short, so a simple byte-wise hash is cheaper than anything that needs setup.
+static u_int32_t hashBytes(const char* pData, size_t uiLength) {
+	u_int32_t uiHash = 2166136261u;
+	for (size_t i=0; i<uiLength; i++) {
+		uiHash = (uiHash ^ (unsigned char)pData[i]) * 16777619u;
+	}
+	return uiHash;
+}
+
+static u_int32_t readLength(const char* pData) {
+	const unsigned char* p = (const unsigned char*)pData;
+	return (u_int32_t)p[0] | ((u_int32_t)p[1] << 8) | ((u_int32_t)p[2] << 16) | ((u_int32_t)p[3] << 24);
+}
+
+stringTable::stringTable() : m_vecSlots(STRINGTABLE_INITIAL_SLOTS, 0) {
+}
+
+u_int32_t stringTable::intern(const char* pData, size_t uiLength) {
+	u_int32_t uiHash = hashBytes(pData, uiLength);
+	size_t uiMask = m_vecSlots.size() - 1;
+
+	for (size_t i = uiHash & uiMask; ; i = (i + 1) & uiMask) {
+		u_int32_t uiSlot = m_vecSlots[i];
+		if (!uiSlot) {
+			u_int32_t uiID = m_vecOffsets.size();
+			m_vecSlots[i] = uiID + 1;
+			m_vecHashes.push_back(uiHash);
+			m_vecOffsets.push_back(m_strEntries.length());
+			for (int iShift=0; iShift<32; iShift+=8) {
+				m_strEntries.push_back((char)((uiLength >> iShift) & 0xff));
+			}
+			m_strEntries.append(pData, uiLength);
+
+			if (m_vecOffsets.size() * 2 > m_vecSlots.size()) {
+				grow();
+			}
+			return uiID;
+		}
+
+		u_int32_t uiID = uiSlot - 1;
+		if (m_vecHashes[uiID] == uiHash) {
+			const char* pEntry = m_strEntries.data() + m_vecOffsets[uiID];
+			if (readLength(pEntry) == uiLength && memcmp(pEntry + 4, pData, uiLength) == 0) {
+				return uiID;
+			}
+		}
+	}
+}
+
+string stringTable::getString(u_int32_t uiID) const {
+	if (uiID >= m_vecOffsets.size()) {
+		return "";
+	}
+	const char* pEntry = m_strEntries.data() + m_vecOffsets[uiID];
+	return string(pEntry + 4, readLength(pEntry));
+}
+
+void stringTable::appendString(u_int32_t uiID, string* pstrOutput) const {
+	if (uiID < m_vecOffsets.size()) {
+		const char* pEntry = m_strEntries.data() + m_vecOffsets[uiID];
+		pstrOutput->append(pEntry + 4, readLength(pEntry));
+	}
+}
+
+void stringTable::grow() {
+	m_vecSlots.assign(m_vecSlots.size() * 2, 0);
+	size_t uiMask = m_vecSlots.size() - 1;
+	for (u_int32_t uiID=0; uiID<m_vecHashes.size(); uiID++) {
+		size_t i = m_vecHashes[uiID] & uiMask;
+		while (m_vecSlots[i]) {
+			i = (i + 1) & uiMask;
+		}
+		m_vecSlots[i] = uiID + 1;
+	}
+	DEBUG("stringTable::grow() " << m_vecSlots.size() << " slots for " << m_vecHashes.size() << " values");
+}
+
+// Keeps the slot array at its current size; tables that are refilled with similar data avoid regrowing each time.
+void stringTable::clear() {
+	if (m_vecOffsets.size()) {
+		fill(m_vecSlots.begin(), m_vecSlots.end(), 0);
+		m_vecHashes.clear();
+		m_vecOffsets.clear();
+		m_strEntries.clear();
+	}
+}
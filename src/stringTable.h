@@ -0,0 +1,53 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_STRINGTABLE_H_
+#define MULTI2MACTIME_STRINGTABLE_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Interning table for column values that repeat across many rows (LOG-SRC, TYPE, FROM/TO addresses, ...). Each distinct
+// value is stored once and identified by a small integer id, assigned in order of first appearance. Values live in a
+// single buffer as consecutive (u32 little-endian length, bytes) entries, which is also how the binary writers
+// serialize a dictionary, so getEntries() can be written out as-is. Lookups use an open-addressed hash table of ids.
+//
+// Used for the --binary block dictionaries and for the TYPE/LOG-SRC values of rows buffered by --sort.
+
+class stringTable {
+	public:
+		stringTable();
+
+		u_int32_t intern(const char* pData, size_t uiLength);
+		u_int32_t intern(const string& strValue) { return intern(strValue.data(), strValue.length()); }
+
+		size_t size() const { return m_vecOffsets.size(); }
+		string getString(u_int32_t uiID) const;
+		void appendString(u_int32_t uiID, string* pstrOutput) const;
+		// Approximate heap use, for callers working to a memory budget
+		size_t getMemory() const { return m_strEntries.length() + m_vecOffsets.size() * (sizeof(size_t) + sizeof(u_int32_t)) + m_vecSlots.size() * sizeof(u_int32_t); }
+		const string& getEntries() const { return m_strEntries; }
+		void clear();
+
+	private:
+		void grow();
+
+		vector<u_int32_t> m_vecSlots;			// id + 1, or 0 if empty
+		vector<u_int32_t> m_vecHashes;			// per id
+		vector<size_t> m_vecOffsets;				// per id, offset of the entry in m_strEntries
+		string m_strEntries;
+};
+
+#endif /*MULTI2MACTIME_STRINGTABLE_H_*/
@@ -17,6 +17,10 @@
 #include "misc/errMsgs.h"
 
 #include "processor.h"
+#include "logLimiter.h"
+#include "spanTracer.h"
+#include "syslog.h"
+#include "keyScanner.h"
 
 #include <string>
 using namespace std;
@@ -27,30 +31,62 @@ using namespace std;
 #include "libdelimText/src/delimTextRow.h"
 #include "misc/boost_lexical_cast_wrapper.hpp"
 
-void processSymantec(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields) {
+#define SYMANTEC_KEY_SENT	0
+#define SYMANTEC_KEY_RCVD	1
+#define SYMANTEC_KEY_SRC	2
+#define SYMANTEC_KEY_DST	3
+#define SYMANTEC_KEY_COUNT	4
+
+static const keyDefinition SYMANTEC_KEYS[SYMANTEC_KEY_COUNT] = {
+	{"sent=",	" "},
+	{"rcvd=",	" "},
+	{"src=",		"/"},
+	{"dst=",		"/"},
+};
+static const keyScanner symantecKeys(SYMANTEC_KEYS, SYMANTEC_KEY_COUNT);
+
+void processSymantec(string* pstrData, u_int16_t uiYear, u_int32_t uiSkew, bool bNormalize, timeZoneCalculator* pTZCalc, string* strFields, const syslogHeader* pHeader) {
 	DEBUG("processSymantec()");
 
-	int32_t timeVal = 0;
-	boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
-	if (pTZCalc->createLocalTime(boost_lexical_cast_wrapper<string>(uiYear) + " " + string(*pstrData, 0, 19), "%Y %b %d %H:%M:%S%F", &ldt)) {
-		timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
+	// Mar 20 12:00:00.123 fw1 httpd[1234]: 121 Statistics: duration=0.13 sent=523 rcvd=2245 src=10.0.0.2/1193 dst=10.1.1.1/80 ...
+	syslogHeader header;
+	if (pHeader != NULL) {
+		header = *pHeader;
 	} else {
-		ERROR("processSymantec() Unable to createLocalTime()");
+		decodeSyslogHeader(pstrData, &header);
+	}
+	size_t posBody = header.posBody;
+
+	int32_t timeVal = 0;
+	{
+		traceStage stage(SPANTRACER_STAGE_TIME);
+		boost::local_time::local_date_time ldt(boost::local_time::not_a_date_time);
+		if (pTZCalc->createLocalTime(boost_lexical_cast_wrapper<string>(uiYear) + " " + getSpanString(pstrData, header.spanTime), "%Y %b %d %H:%M:%S%F", &ldt)) {
+			timeVal = getUnix32FromLocalTime(ldt + boost::posix_time::seconds(uiSkew));
+		} else {
+			countTimeFailure();
+			ROW_ERROR("processSymantec() Unable to createLocalTime()", "");
+		}
+	}
+	if (!inTimeWindow(timeVal)) {
+		return;
 	}
 	
-	string strMsgType = findSubString(*pstrData, 23, "", ": ");
-	string strMsg = findSubString(*pstrData, 23, ": ", "");
+	string strMsgType = getSpanString(pstrData, header.spanTag);
+	string strMsg = pstrData->substr(posBody);
+
+	textSpan spans[SYMANTEC_KEY_COUNT];
+	symantecKeys.scan(pstrData, posBody, spans);
 
 	string strBytes;
-	string strSent = findSubString(*pstrData, 23, "sent=", " ");
-	string strRcvd = findSubString(*pstrData, 23, "rcvd=", " ");
+	string strSent = getSpanString(pstrData, spans[SYMANTEC_KEY_SENT]);
+	string strRcvd = getSpanString(pstrData, spans[SYMANTEC_KEY_RCVD]);
 	if (strSent.length() || strRcvd.length()) {
 			strBytes = strSent + "/" + strRcvd;
 	}
 
-	string strService = findSubString(findSubString(*pstrData, 23, "", ": "), 0, "", "[");
-	string strSrc = findSubString(*pstrData, 23, "src=", "/");
-	string strDst = findSubString(*pstrData, 23, "dst=", "/");
+	string strSrc = getSpanString(pstrData, spans[SYMANTEC_KEY_SRC]);
+	string strDst = getSpanString(pstrData, spans[SYMANTEC_KEY_DST]);
 
 	//Output Values
 	strFields[MULTI2MAC_DETAIL]	= strMsg;
@@ -0,0 +1,219 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "syslog.h"
+#include "textSearch.h"
+
+#include <string>
+#include <cctype>
+#include <cstring>
+using namespace std;
+
+static inline textSpan makeSpan(size_t pos, size_t len) {
+	textSpan span;
+	span.pos = pos;
+	span.len = len;
+	return span;
+}
+
+// Returns the end of the space-delimited token starting at pos.
+static inline size_t tokenEnd(const string* pstrData, size_t pos) {
+	size_t posEnd = pstrData->find(' ', pos);
+	return (posEnd != string::npos ? posEnd : pstrData->length());
+}
+
+// Matches "Mmm dd hh:mm:ss[.fff]" or, when bYear is set, "Mmm dd yyyy hh:mm:ss"; returns the length matched or 0.
+static size_t matchBSDTime(const string* pstrData, size_t pos, bool bYear) {
+	const char* p = pstrData->c_str() + pos;
+	size_t len = pstrData->length() - pos;
+	size_t lenTime = (bYear ? 20 : 15);
+
+	if (len < lenTime ||
+			!isalpha((unsigned char)p[0]) || !isalpha((unsigned char)p[1]) || !isalpha((unsigned char)p[2]) || p[3] != ' ' ||
+			!(isdigit((unsigned char)p[4]) || p[4] == ' ') || !isdigit((unsigned char)p[5]) || p[6] != ' ') {
+		return 0;
+	}
+	if (bYear) {
+		if (!isdigit((unsigned char)p[7]) || !isdigit((unsigned char)p[8]) || !isdigit((unsigned char)p[9]) || !isdigit((unsigned char)p[10]) || p[11] != ' ') {
+			return 0;
+		}
+		p += 5;
+	}
+	if (!isdigit((unsigned char)p[7]) || !isdigit((unsigned char)p[8]) || p[9] != ':' || !isdigit((unsigned char)p[10]) || !isdigit((unsigned char)p[11]) || p[12] != ':' || !isdigit((unsigned char)p[13]) || !isdigit((unsigned char)p[14])) {
+		return 0;
+	}
+	if (!bYear && len > lenTime && p[15] == '.') {
+		lenTime++;
+		while (lenTime < len && isdigit((unsigned char)p[lenTime])) {
+			lenTime++;
+		}
+	}
+
+	return lenTime;
+}
+
+bool decodeSyslogHeader(const string* pstrData, syslogHeader* pHeader) {
+	DEBUG("decodeSyslogHeader()");
+
+	pHeader->iFormat = SYSLOG_FORMAT_UNKNOWN;
+	pHeader->spanTime = pHeader->spanHost = pHeader->spanDeviceTime = pHeader->spanTag = pHeader->spanMsgID = makeSpan(0, 0);
+	pHeader->posBody = 0;
+
+	size_t len = pstrData->length();
+	size_t pos = 0;
+
+	// Optional <PRI>
+	bool bPRI = false;
+	if (len && (*pstrData)[0] == '<') {
+		size_t posClose = pstrData->find('>');
+		if (posClose != string::npos && posClose <= 4) {
+			pos = posClose + 1;
+			bPRI = true;
+		}
+	}
+
+	// RFC5424 has the <PRI> immediately followed by the version, 1, and a space; anything else (e.g. a relay that drops
+	// the PRI and starts the line with a number) is left to the RFC3164 parsing below
+	if (bPRI && pos + 1 < len && (*pstrData)[pos] == '1' && (*pstrData)[pos + 1] == ' ') {
+		pos += 2;
+		textSpan* spans[4] = { &pHeader->spanTime, &pHeader->spanHost, &pHeader->spanTag, &pHeader->spanMsgID };
+		for (int i=0; i<5 && pos < len; i++) {
+			size_t posEnd = tokenEnd(pstrData, pos);
+			if (i < 3) {
+				*spans[i] = makeSpan(pos, posEnd - pos);
+			} else if (i == 4) {
+				*spans[3] = makeSpan(pos, posEnd - pos);
+			}
+			pos = posEnd + 1;
+		}
+		// Skip a nil structured data element; otherwise leave it as part of the body
+		if (pos + 1 <= len && (*pstrData)[pos] == '-' && (pos + 1 == len || (*pstrData)[pos + 1] == ' ')) {
+			pos += 2;
+		}
+		pHeader->iFormat = SYSLOG_FORMAT_RFC5424;
+		pHeader->posBody = (pos < len ? pos : len);
+		return true;
+	}
+
+	// RFC3164 "Mmm dd hh:mm:ss" (some collectors substitute an ISO 8601 timestamp)
+	size_t lenTime = matchBSDTime(pstrData, pos, false);
+	if (!lenTime && pos + 5 <= len && isdigit((unsigned char)(*pstrData)[pos]) && isdigit((unsigned char)(*pstrData)[pos + 1]) && isdigit((unsigned char)(*pstrData)[pos + 2]) &&
+			isdigit((unsigned char)(*pstrData)[pos + 3]) && (*pstrData)[pos + 4] == '-') {
+		lenTime = tokenEnd(pstrData, pos) - pos;
+	}
+	if (!lenTime) {
+		return false;
+	}
+	pHeader->spanTime = makeSpan(pos, lenTime);
+	pos += lenTime + 1;
+
+	if (pos < len) {
+		size_t posEnd = tokenEnd(pstrData, pos);
+		pHeader->spanHost = makeSpan(pos, posEnd - pos);
+		pos = (posEnd < len ? posEnd + 1 : len);
+	}
+
+	// Device generated timestamp (e.g. PIX/ASA "Mmm dd yyyy hh:mm:ss: ")
+	lenTime = matchBSDTime(pstrData, pos, true);
+	if (lenTime && pos + lenTime < len && (*pstrData)[pos + lenTime] == ':') {
+		pHeader->spanDeviceTime = makeSpan(pos, lenTime);
+		pos += lenTime + 1;
+		while (pos < len && (*pstrData)[pos] == ' ') {
+			pos++;
+		}
+	}
+
+	// TAG is terminated by ':'; a token without one is already part of the body
+	size_t posEnd = tokenEnd(pstrData, pos);
+	if (posEnd > pos && (*pstrData)[posEnd - 1] == ':') {
+		pHeader->spanTag = makeSpan(pos, posEnd - 1 - pos);
+		pos = (posEnd < len ? posEnd + 1 : len);
+	}
+
+	pHeader->iFormat = SYSLOG_FORMAT_RFC3164;
+	pHeader->posBody = pos;
+	return true;
+}
+
+// Symantec gateway messages are "<message id> <event>: ..." (e.g. "121 Statistics: duration=0.13 sent=523 ...") or carry
+// proxy_id= or an address/port key (src=10.0.0.2/1193). A number after a name[pid]: tag alone is common to every
+// daemon, so these stay unknown:
+//
+//		Mar 20 12:00:00 host sshd[1234]: 3 authentication failures for root
+//		Mar 20 12:00:00 host cron[99]: 0 jobs queued
+static const char* SYMANTEC_EVENTS[] = { "Statistics:", "Connection:", "Connect:", "Deny:", "Denied:", "Accept:", "Drop:", "Dropped:", "Limit:" };
+
+static bool isSymantecBody(const char* pData, size_t len, size_t pos) {
+	size_t posID = pos;
+	while (pos < len && isdigit((unsigned char)pData[pos])) {
+		pos++;
+	}
+	if (pos == posID || pos >= len || pData[pos] != ' ') {
+		return false;
+	}
+	pos++;
+
+	for (size_t i=0; i<sizeof(SYMANTEC_EVENTS)/sizeof(SYMANTEC_EVENTS[0]); i++) {
+		size_t lenEvent = strlen(SYMANTEC_EVENTS[i]);
+		if (len - pos >= lenEvent && memcmp(pData + pos, SYMANTEC_EVENTS[i], lenEvent) == 0) {
+			return true;
+		}
+	}
+	if (findText(pData, len, pos, "proxy_id=", 9) != string::npos) {
+		return true;
+	}
+	size_t posSrc = findText(pData, len, pos, "src=", 4);
+	if (posSrc != string::npos) {
+		size_t posValue = posSrc + 4;
+		while (posValue < len && pData[posValue] != ' ' && pData[posValue] != '/') {
+			posValue++;
+		}
+		return (posValue > posSrc + 4 && posValue + 1 < len && pData[posValue] == '/' && isdigit((unsigned char)pData[posValue + 1]));
+	}
+	return false;
+}
+
+static const char* SYSLOG_CLASS_NAMES[SYSLOG_CLASS_COUNT] = { "unknown", "pix", "juniper", "symantec", "fortg1k5" };
+
+int classifySyslog(const string* pstrData, syslogHeader* pHeader) {
+	bool bHeader = decodeSyslogHeader(pstrData, pHeader);
+	const char* pData = pstrData->data();
+	size_t len = pstrData->length();
+	const textSpan& tag = pHeader->spanTag;
+
+	if (tag.len >= 5 && (memcmp(pData + tag.pos, "%PIX-", 5) == 0 || memcmp(pData + tag.pos, "%ASA-", 5) == 0)) {
+		return SYSLOG_CLASS_PIX;
+	}
+	if (findText(pData + tag.pos, tag.len, 0, "RT_FLOW", 7) != string::npos ||
+			findText(pData + pHeader->spanMsgID.pos, pHeader->spanMsgID.len, 0, "RT_FLOW", 7) != string::npos ||
+			pstrData->compare(pHeader->posBody, 20, "NetScreen device_id=") == 0) {
+		return SYSLOG_CLASS_JUNIPER;
+	}
+	if (findText(pData, len, pHeader->posBody, "devid=FG", 8) != string::npos || findText(pData, len, pHeader->posBody, "devid=\"FG", 9) != string::npos) {
+		return SYSLOG_CLASS_FORTIGATE;
+	}
+	if (bHeader && tag.len && pData[tag.pos + tag.len - 1] == ']' && isSymantecBody(pData, len, pHeader->posBody)) {
+		return SYSLOG_CLASS_SYMANTEC;
+	}
+
+	return SYSLOG_CLASS_UNKNOWN;
+}
+
+const char* getSyslogClassName(int iClass) {
+	return (iClass >= 0 && iClass < SYSLOG_CLASS_COUNT ? SYSLOG_CLASS_NAMES[iClass] : SYSLOG_CLASS_NAMES[SYSLOG_CLASS_UNKNOWN]);
+}
@@ -0,0 +1,70 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_SYSLOG_H_
+#define MULTI2MACTIME_SYSLOG_H_
+
+#include <string>
+using namespace std;
+
+#include "processor.h"
+
+// Decodes the header that a syslog collector puts in front of each device message, so the device parsers (PIX,
+// Juniper, Symantec) can start from the message body instead of hard-coded offsets. Both the traditional BSD format
+// (RFC3164) and the newer structured format (RFC5424) are recognized:
+//
+//		RFC3164:	[<PRI>]Mmm dd hh:mm:ss[.fff] HOST [DEVICE-TIME: ]TAG: BODY
+//		RFC5424:	<PRI>1 YYYY-MM-DDThh:mm:ss[.fff]TZ HOST APP-NAME PROCID MSGID [SD|-] BODY
+//
+// DEVICE-TIME covers devices (e.g. PIX/ASA) that insert their own "Mmm dd yyyy hh:mm:ss" timestamp ahead of the tag.
+// For RFC5424 the body begins at the structured data (if any) so key=value parsers still see it.
+//
+// Every value is returned as a position/length span into the original line; nothing is copied.
+
+#define SYSLOG_FORMAT_UNKNOWN	0
+#define SYSLOG_FORMAT_RFC3164	1
+#define SYSLOG_FORMAT_RFC5424	2
+
+struct syslogHeader {
+	int iFormat;
+	textSpan spanTime;				// Time the collector received the message
+	textSpan spanHost;
+	textSpan spanDeviceTime;		// Time generated by the device itself, if present
+	textSpan spanTag;				// Program tag (RFC3164) or APP-NAME (RFC5424)
+	textSpan spanMsgID;			// RFC5424 only
+	size_t posBody;
+};
+
+bool decodeSyslogHeader(const string* pstrData, syslogHeader* pHeader);
+
+// Mixed-source collectors (--type auto-syslog) write lines from several devices into the same file. classifySyslog()
+// decodes the header and identifies the device from cheap prefix/tag checks so the line can be handed to the matching
+// parser along with the already decoded header:
+//
+//		PIX/ASA		tag starts with "%PIX-" or "%ASA-"
+//		Juniper		tag or message id contains "RT_FLOW", or the body starts with "NetScreen device_id="
+//		FortiGate	line contains "devid=FG" or devid="FG (native key=value syslog, not the CSV export)
+//		Symantec	tag of the form "name[pid]" followed by a numeric message id (e.g. "httpd[1234]: 121 ...")
+
+#define SYSLOG_CLASS_UNKNOWN		0
+#define SYSLOG_CLASS_PIX			1
+#define SYSLOG_CLASS_JUNIPER		2
+#define SYSLOG_CLASS_SYMANTEC		3
+#define SYSLOG_CLASS_FORTIGATE	4
+#define SYSLOG_CLASS_COUNT			5
+
+int classifySyslog(const string* pstrData, syslogHeader* pHeader);
+const char* getSyslogClassName(int iClass);
+
+#endif /*MULTI2MACTIME_SYSLOG_H_*/
@@ -0,0 +1,101 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "textSearch.h"
+
+#include <string>
+#include <cstring>
+using namespace std;
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+size_t findText(const char* pData, size_t len, size_t pos, const char* pNeedle, size_t lenNeedle) {
+	if (pos > len || len - pos < lenNeedle) {
+		return string::npos;
+	}
+	if (lenNeedle == 0) {
+		return pos;
+	}
+	if (lenNeedle == 1) {
+		const char* p = (const char*)memchr(pData + pos, pNeedle[0], len - pos);
+		return (p ? p - pData : string::npos);
+	}
+
+	const char* p = pData + pos;
+	size_t uiCandidates = len - pos - lenNeedle + 1;
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	const __m256i vFirst = _mm256_set1_epi8(pNeedle[0]);
+	const __m256i vLast = _mm256_set1_epi8(pNeedle[lenNeedle - 1]);
+	for (; i + 32 <= uiCandidates; i += 32) {
+		__m256i vBlockFirst = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i vBlockLast = _mm256_loadu_si256((const __m256i*)(p + i + lenNeedle - 1));
+		u_int32_t uiMask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(vFirst, vBlockFirst), _mm256_cmpeq_epi8(vLast, vBlockLast)));
+		while (uiMask) {
+			size_t uiBit = __builtin_ctz(uiMask);
+			if (memcmp(p + i + uiBit + 1, pNeedle + 1, lenNeedle - 2) == 0) {
+				return pos + i + uiBit;
+			}
+			uiMask &= uiMask - 1;
+		}
+	}
+#elif defined(__SSE2__)
+	const __m128i vFirst = _mm_set1_epi8(pNeedle[0]);
+	const __m128i vLast = _mm_set1_epi8(pNeedle[lenNeedle - 1]);
+	for (; i + 16 <= uiCandidates; i += 16) {
+		__m128i vBlockFirst = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i vBlockLast = _mm_loadu_si128((const __m128i*)(p + i + lenNeedle - 1));
+		u_int32_t uiMask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(vFirst, vBlockFirst), _mm_cmpeq_epi8(vLast, vBlockLast)));
+		while (uiMask) {
+			size_t uiBit = __builtin_ctz(uiMask);
+			if (memcmp(p + i + uiBit + 1, pNeedle + 1, lenNeedle - 2) == 0) {
+				return pos + i + uiBit;
+			}
+			uiMask &= uiMask - 1;
+		}
+	}
+#endif
+
+	for (; i < uiCandidates; i++) {
+		if (p[i] == pNeedle[0] && p[i + lenNeedle - 1] == pNeedle[lenNeedle - 1] && memcmp(p + i + 1, pNeedle + 1, lenNeedle - 2) == 0) {
+			return pos + i;
+		}
+	}
+
+	return string::npos;
+}
+
+size_t findText(const string* pstrData, size_t pos, const char* cstrNeedle) {
+	return findText(pstrData->data(), pstrData->length(), pos, cstrNeedle, strlen(cstrNeedle));
+}
+
+textSpan findTextSpan(const string* pstrData, size_t pos, const char* cstrStart, const char* cstrEnd) {
+	textSpan span;
+	span.pos = span.len = 0;
+
+	size_t lenStart = strlen(cstrStart);
+	size_t posStart = findText(pstrData->data(), pstrData->length(), pos, cstrStart, lenStart);
+	if (posStart != string::npos) {
+		span.pos = posStart + lenStart;
+		size_t posEnd = (*cstrEnd ? findText(pstrData, span.pos, cstrEnd) : string::npos);
+		span.len = (posEnd != string::npos ? posEnd : pstrData->length()) - span.pos;
+	}
+
+	return span;
+}
@@ -0,0 +1,39 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_TEXTSEARCH_H_
+#define MULTI2MACTIME_TEXTSEARCH_H_
+
+#include <string>
+using namespace std;
+
+#include "processor.h"
+
+// Vectorized substring search used in place of libdelimText's findSubString() on the per-row paths. Candidate
+// positions are found by comparing the first and last byte of the needle against 32 (AVX2) or 16 (SSE2) bytes of
+// input at a time; only positions where both match are verified with memcmp(). Builds without either instruction
+// set fall back to a scalar loop with the same filtering.
+//
+// findText() returns the position of the needle at or after pos, or string::npos.
+//
+// findTextSpan() mirrors findSubString(data, pos, start, end) but returns a span into the line instead of a copy:
+// the text between the first start marker at or after pos and the following end marker. An empty start marker
+// begins at pos; an empty (or missing) end marker runs to the end of the line. A missing start marker returns an
+// empty span.
+
+size_t findText(const char* pData, size_t len, size_t pos, const char* pNeedle, size_t lenNeedle);
+size_t findText(const string* pstrData, size_t pos, const char* cstrNeedle);
+textSpan findTextSpan(const string* pstrData, size_t pos, const char* cstrStart, const char* cstrEnd);
+
+#endif /*MULTI2MACTIME_TEXTSEARCH_H_*/
@@ -0,0 +1,88 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//#define _DEBUG_
+#include "misc/debugMsgs.h"
+#include "misc/errMsgs.h"
+
+#include "timeIndex.h"
+#include "logLimiter.h"
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <inttypes.h>
+using namespace std;
+
+#define TIMEINDEX_HEADER	"# multi2mactime index"
+
+timeIndex::timeIndex(u_int32_t uiBucket) : m_uiBucket(uiBucket ? uiBucket : TIMEINDEX_DEFAULT_BUCKET), m_uiOffset(0) {
+}
+
+void timeIndex::addRow(u_int32_t uiTime, u_int64_t uiLength) {
+	if (uiTime) {
+		u_int32_t uiBucketStart = uiTime - (uiTime % m_uiBucket);
+		if (m_vecEntries.empty() || uiBucketStart > m_vecEntries.back().first) {
+			m_vecEntries.push_back(make_pair(uiBucketStart, m_uiOffset));
+		}
+	}
+	m_uiOffset += uiLength;
+}
+
+bool timeIndex::write(string strFilename) const {
+	FILE* pFile = fopen(strFilename.c_str(), "w");
+	if (!pFile) {
+		LOG_ERROR("timeIndex::write() Unable to create " << strFilename);
+		return false;
+	}
+
+	fprintf(pFile, "%s %u\n", TIMEINDEX_HEADER, m_uiBucket);
+	for (vector<pair<u_int32_t, u_int64_t> >::const_iterator it = m_vecEntries.begin(); it != m_vecEntries.end(); it++) {
+		fprintf(pFile, "%u %" PRIu64 "\n", it->first, (uint64_t)it->second);
+	}
+
+	if (fclose(pFile) != 0) {
+		LOG_ERROR("timeIndex::write() Unable to write " << strFilename);
+		return false;
+	}
+	DEBUG("timeIndex::write() " << m_vecEntries.size() << " entries to " << strFilename);
+	return true;
+}
+
+// Offset of the last bucket starting at or before uiTime (0 if uiTime precedes every bucket).
+bool timeIndex::lookup(string strFilename, u_int32_t uiTime, u_int64_t* puiOffset) {
+	FILE* pFile = fopen(strFilename.c_str(), "r");
+	if (!pFile) {
+		LOG_ERROR("timeIndex::lookup() Unable to open " << strFilename);
+		return false;
+	}
+
+	bool rv = false;
+	char cstrLine[256];
+	if (fgets(cstrLine, sizeof(cstrLine), pFile) && strncmp(cstrLine, TIMEINDEX_HEADER, strlen(TIMEINDEX_HEADER)) == 0) {
+		rv = true;
+		*puiOffset = 0;
+		unsigned int uiBucketStart = 0;
+		uint64_t uiOffset = 0;
+		while (fscanf(pFile, "%u %" SCNu64, &uiBucketStart, &uiOffset) == 2 && uiBucketStart <= uiTime) {
+			*puiOffset = uiOffset;
+		}
+	} else {
+		LOG_ERROR("timeIndex::lookup() " << strFilename << " is not a multi2mactime index");
+	}
+
+	fclose(pFile);
+	return rv;
+}
@@ -0,0 +1,50 @@
+// Copyright 2019 Matthew A. Kucenski
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MULTI2MACTIME_TIMEINDEX_H_
+#define MULTI2MACTIME_TIMEINDEX_H_
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Sparse index of a time ordered body file (--index with --sort or --merge-sorted). As rows are written, the byte
+// offset of the first row in each time bucket is recorded; the index file is plain text:
+//
+//	# multi2mactime index <bucket seconds>
+//	<bucket start time> <byte offset>
+//	...
+//
+// Offsets are relative to the start of the body output. Rows without a time and rows that are earlier than a bucket
+// already recorded (out of order input to --merge-sorted) do not create entries. lookup() returns the offset to start
+// reading from to find the first row at or after a time; rows before it in the same bucket must still be skipped.
+
+#define TIMEINDEX_DEFAULT_BUCKET	60		// seconds
+
+class timeIndex {
+	public:
+		timeIndex(u_int32_t uiBucket = TIMEINDEX_DEFAULT_BUCKET);
+
+		void addRow(u_int32_t uiTime, u_int64_t uiLength);
+		bool write(string strFilename) const;
+
+		static bool lookup(string strFilename, u_int32_t uiTime, u_int64_t* puiOffset);
+
+	private:
+		u_int32_t m_uiBucket;
+		u_int64_t m_uiOffset;
+		vector<pair<u_int32_t, u_int64_t> > m_vecEntries;
+};
+
+#endif /*MULTI2MACTIME_TIMEINDEX_H_*/